@@ -0,0 +1,58 @@
+#ifndef LIDARRECORDERWIDGET_HPP
+#define LIDARRECORDERWIDGET_HPP
+
+#include <QWidget>
+#include <QFile>
+#include <QSerialPort>
+#include "LidarStream.hpp"
+
+class QComboBox;
+class QPushButton;
+class QLabel;
+class QTimer;
+class LidarViewWidget;
+
+// Reads the LidarStream framing from the USB CDC port of the lidar_stream
+// sketch, draws it, and records the byte stream to a file or replays one.
+// Decoding is the firmware's own LidarStreamDecoder.
+class LidarRecorderWidget : public QWidget {
+    Q_OBJECT
+public:
+    explicit LidarRecorderWidget(QWidget *parent = nullptr);
+    ~LidarRecorderWidget();
+
+private slots:
+    void onRefreshClicked();
+    void onOpenClicked();
+    void onModeChanged(int index);
+    void onRecordClicked();
+    void onReplayClicked();
+    void onReadyRead();
+    void onReplayTick();
+    void updateStatus();
+
+private:
+    QSerialPort *serial;
+    QFile recordFile;
+    QFile replayFile;
+    QTimer *replayTimer;
+    QTimer *statusTimer;
+    LidarStreamDecoder decoder;
+    LidarViewWidget *view;
+
+    QComboBox *portComboBox;
+    QComboBox *modeComboBox;
+    QPushButton *refreshButton;
+    QPushButton *openButton;
+    QPushButton *recordButton;
+    QPushButton *replayButton;
+    QLabel *statusLabel;
+
+    quint32 pointCount;
+    quint32 lastPointCount;
+
+    void consume(const QByteArray &data);
+    static void onBatch(const LidarPointBatch &batch, void *context);
+};
+
+#endif
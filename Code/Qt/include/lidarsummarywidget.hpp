@@ -0,0 +1,37 @@
+#ifndef LIDARSUMMARYWIDGET_HPP
+#define LIDARSUMMARYWIDGET_HPP
+
+#include <QWidget>
+#include <QLowEnergyService>
+#include "LidarSummary.hpp"
+#include "LidarHealth.hpp"
+
+class QLabel;
+class QTimer;
+class LidarViewWidget;
+
+// Shows the per-revolution lidar summaries the robot notifies over BLE,
+// decoded with the firmware's LidarSummaryDecoder, and its lidar health reports
+class LidarSummaryWidget : public QWidget {
+    Q_OBJECT
+public:
+    explicit LidarSummaryWidget(QLowEnergyService *service, QWidget *parent = nullptr);
+    void setService(QLowEnergyService *service);
+
+private slots:
+    void onCharacteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &value);
+    void updateStatus();
+
+private:
+    QLowEnergyService *service;
+    QBluetoothUuid notifyUuid;
+    LidarSummaryDecoder decoder;
+    LidarViewWidget *view;
+    QLabel *statusLabel;
+    QTimer *statusTimer;
+    int scanCount;
+    LidarHealthReport health;
+    bool hasHealth;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef LIDARVIEWWIDGET_HPP
+#define LIDARVIEWWIDGET_HPP
+
+#include <QWidget>
+#include <QVector>
+#include <QPointF>
+#include <QPoint>
+
+struct LidarPointBatch;
+
+// Top view of one lidar revolution, robot forward up. Keeps the latest return
+// of every 0.5 degree bin instead of a FIFO of points, so a whole turn is
+// always on screen. Wheel zooms, left drag pans.
+class LidarViewWidget : public QWidget {
+    Q_OBJECT
+public:
+    static const int BINS = 720;
+
+    explicit LidarViewWidget(QWidget *parent = nullptr);
+
+    void addBatch(const LidarPointBatch &batch);
+    void setSectors(const QVector<quint16> &sectorDistances);  // Coarse revolution, mm, 0 = no return
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+private:
+    QVector<quint16> distances;  // mm per bin, 0 = no return
+    QVector<quint8> intensities;
+    double zoom;
+    QPointF pan;
+    QPoint lastMouse;
+};
+
+#endif
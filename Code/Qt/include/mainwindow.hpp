@@ -7,6 +7,9 @@
 #include "ledcontrolwidget.hpp"
 #include "robotcontrolwidget.hpp"
 #include "magnetometerwidget.hpp"
+#include "beaconcontrolwidget.hpp"
+#include "lidarrecorderwidget.hpp"
+#include "lidarsummarywidget.hpp"
 
 class MainWindow : public QMainWindow
 {
@@ -23,6 +26,9 @@ private:
     LEDControlWidget *ledControlWidget;
     RobotControlWidget *robotControlWidget;
     MagnetometerWidget *magWidget;
+    BeaconControlWidget *beaconControlWidget;
+    LidarRecorderWidget *lidarRecorderWidget;
+    LidarSummaryWidget *lidarSummaryWidget;
 
 };
 
@@ -0,0 +1,204 @@
+#include "../include/lidarrecorderwidget.hpp"
+#include "../include/lidarviewwidget.hpp"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QComboBox>
+#include <QPushButton>
+#include <QLabel>
+#include <QTimer>
+#include <QFileDialog>
+#include <QSerialPortInfo>
+#include <QDebug>
+
+static const int REPLAY_INTERVAL = 20;     // ms
+static const int REPLAY_CHUNK = 512;       // bytes per tick, about the points mode rate
+
+LidarRecorderWidget::LidarRecorderWidget(QWidget *parent)
+    : QWidget(parent), pointCount(0), lastPointCount(0)
+{
+    serial = new QSerialPort(this);
+    replayTimer = new QTimer(this);
+    statusTimer = new QTimer(this);
+    view = new LidarViewWidget(this);
+
+    portComboBox = new QComboBox(this);
+    refreshButton = new QPushButton("Refresh", this);
+    openButton = new QPushButton("Open", this);
+
+    modeComboBox = new QComboBox(this);
+    modeComboBox->addItem("Points");
+    modeComboBox->addItem("Raw frames");
+
+    recordButton = new QPushButton("Record", this);
+    recordButton->setEnabled(false);
+    replayButton = new QPushButton("Replay", this);
+    statusLabel = new QLabel(this);
+
+    QHBoxLayout *portLayout = new QHBoxLayout;
+    portLayout->addWidget(portComboBox, 1);
+    portLayout->addWidget(refreshButton);
+    portLayout->addWidget(openButton);
+    portLayout->addWidget(modeComboBox);
+
+    QHBoxLayout *fileLayout = new QHBoxLayout;
+    fileLayout->addWidget(recordButton);
+    fileLayout->addWidget(replayButton);
+    fileLayout->addWidget(statusLabel, 1);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addLayout(portLayout);
+    mainLayout->addWidget(view, 1);
+    mainLayout->addLayout(fileLayout);
+
+    connect(refreshButton, &QPushButton::clicked, this, &LidarRecorderWidget::onRefreshClicked);
+    connect(openButton, &QPushButton::clicked, this, &LidarRecorderWidget::onOpenClicked);
+    connect(modeComboBox, &QComboBox::currentIndexChanged, this, &LidarRecorderWidget::onModeChanged);
+    connect(recordButton, &QPushButton::clicked, this, &LidarRecorderWidget::onRecordClicked);
+    connect(replayButton, &QPushButton::clicked, this, &LidarRecorderWidget::onReplayClicked);
+    connect(serial, &QSerialPort::readyRead, this, &LidarRecorderWidget::onReadyRead);
+    connect(replayTimer, &QTimer::timeout, this, &LidarRecorderWidget::onReplayTick);
+    connect(statusTimer, &QTimer::timeout, this, &LidarRecorderWidget::updateStatus);
+
+    statusTimer->start(1000);
+    onRefreshClicked();
+    updateStatus();
+}
+
+LidarRecorderWidget::~LidarRecorderWidget()
+{
+    if (serial->isOpen()) {
+        serial->close();
+    }
+    recordFile.close();
+    replayFile.close();
+}
+
+void LidarRecorderWidget::onRefreshClicked()
+{
+    portComboBox->clear();
+    for (const QSerialPortInfo &info : QSerialPortInfo::availablePorts()) {
+        portComboBox->addItem(info.portName());
+    }
+}
+
+void LidarRecorderWidget::onOpenClicked()
+{
+    if (serial->isOpen()) {
+        serial->close();
+        recordFile.close();
+        openButton->setText("Open");
+        recordButton->setText("Record");
+        recordButton->setEnabled(false);
+        return;
+    }
+
+    replayTimer->stop();
+    replayFile.close();
+    replayButton->setText("Replay");
+
+    serial->setPortName(portComboBox->currentText());
+    serial->setBaudRate(QSerialPort::Baud115200);  // Ignored by USB CDC
+    if (!serial->open(QIODevice::ReadWrite)) {
+        qDebug() << "LidarRecorderWidget: Cannot open" << serial->portName() << serial->errorString();
+        return;
+    }
+    decoder.reset();
+    view->clear();
+    onModeChanged(modeComboBox->currentIndex());
+    openButton->setText("Close");
+    recordButton->setEnabled(true);
+}
+
+void LidarRecorderWidget::onModeChanged(int index)
+{
+    if (serial->isOpen()) {
+        serial->write(index == 0 ? "P" : "R");
+    }
+}
+
+void LidarRecorderWidget::onRecordClicked()
+{
+    if (recordFile.isOpen()) {
+        recordFile.close();
+        recordButton->setText("Record");
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Record lidar stream", QString(), "Lidar stream (*.lds)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    recordFile.setFileName(fileName);
+    if (!recordFile.open(QIODevice::WriteOnly)) {
+        qDebug() << "LidarRecorderWidget: Cannot write" << fileName;
+        return;
+    }
+    recordButton->setText("Stop recording");
+}
+
+void LidarRecorderWidget::onReplayClicked()
+{
+    if (replayTimer->isActive()) {
+        replayTimer->stop();
+        replayFile.close();
+        replayButton->setText("Replay");
+        return;
+    }
+
+    QString fileName = QFileDialog::getOpenFileName(this, "Replay lidar stream", QString(), "Lidar stream (*.lds)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (serial->isOpen()) {
+        onOpenClicked();  // Closes the port
+    }
+    replayFile.setFileName(fileName);
+    if (!replayFile.open(QIODevice::ReadOnly)) {
+        qDebug() << "LidarRecorderWidget: Cannot read" << fileName;
+        return;
+    }
+    decoder.reset();
+    view->clear();
+    replayButton->setText("Stop replay");
+    replayTimer->start(REPLAY_INTERVAL);
+}
+
+void LidarRecorderWidget::onReadyRead()
+{
+    QByteArray data = serial->readAll();
+    if (recordFile.isOpen()) {
+        recordFile.write(data);
+    }
+    consume(data);
+}
+
+void LidarRecorderWidget::onReplayTick()
+{
+    QByteArray data = replayFile.read(REPLAY_CHUNK);
+    if (data.isEmpty()) {
+        onReplayClicked();  // End of file
+        return;
+    }
+    consume(data);
+}
+
+void LidarRecorderWidget::consume(const QByteArray &data)
+{
+    decoder.parse(reinterpret_cast<const uint8_t *>(data.constData()), data.size(), onBatch, this);
+}
+
+void LidarRecorderWidget::onBatch(const LidarPointBatch &batch, void *context)
+{
+    LidarRecorderWidget *widget = static_cast<LidarRecorderWidget *>(context);
+    widget->pointCount += batch.count;
+    widget->view->addBatch(batch);
+}
+
+void LidarRecorderWidget::updateStatus()
+{
+    statusLabel->setText(QString("%1 points/s, %2 frames, %3 CRC errors")
+                             .arg(pointCount - lastPointCount)
+                             .arg(decoder.getFrameCount())
+                             .arg(decoder.getCrcErrors()));
+    lastPointCount = pointCount;
+}
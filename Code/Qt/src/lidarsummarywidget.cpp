@@ -0,0 +1,95 @@
+#include "../include/lidarsummarywidget.hpp"
+#include "../include/lidarviewwidget.hpp"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTimer>
+#include <QLowEnergyDescriptor>
+#include <QDebug>
+
+LidarSummaryWidget::LidarSummaryWidget(QLowEnergyService *service, QWidget *parent)
+    : QWidget(parent), service(nullptr), scanCount(0), health{}, hasHealth(false)
+{
+    notifyUuid = QBluetoothUuid("beb5483e-36e1-4688-b7f5-ea07361b26a9");
+
+    view = new LidarViewWidget(this);
+    statusLabel = new QLabel(this);
+    statusTimer = new QTimer(this);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(view, 1);
+    mainLayout->addWidget(statusLabel);
+
+    connect(statusTimer, &QTimer::timeout, this, &LidarSummaryWidget::updateStatus);
+    statusTimer->start(1000);
+    updateStatus();
+
+    setService(service);
+}
+
+void LidarSummaryWidget::setService(QLowEnergyService *newService)
+{
+    if (service) {
+        disconnect(service, nullptr, this, nullptr);
+    }
+    service = newService;
+    view->clear();
+    if (!service) {
+        return;
+    }
+
+    QLowEnergyCharacteristic characteristic = service->characteristic(notifyUuid);
+    if (!characteristic.isValid()) {
+        qDebug() << "LidarSummaryWidget: Invalid lidar characteristic";
+        return;
+    }
+
+    connect(service, &QLowEnergyService::characteristicChanged, this, &LidarSummaryWidget::onCharacteristicChanged);
+
+    QLowEnergyDescriptor cccd = characteristic.descriptor(QBluetoothUuid::DescriptorType::ClientCharacteristicConfiguration);
+    if (cccd.isValid()) {
+        service->writeDescriptor(cccd, QLowEnergyCharacteristic::CCCDEnableNotification);
+    }
+}
+
+void LidarSummaryWidget::onCharacteristicChanged(const QLowEnergyCharacteristic &characteristic, const QByteArray &value)
+{
+    if (characteristic.uuid() != notifyUuid) {
+        return;
+    }
+    // Health reports share the characteristic, told apart by their size
+    if (LidarHealth::decode(reinterpret_cast<const uint8_t *>(value.constData()), value.size(), health)) {
+        hasHealth = true;
+        return;
+    }
+    if (!decoder.addChunk(reinterpret_cast<const uint8_t *>(value.constData()), value.size())) {
+        return;
+    }
+
+    QVector<quint16> sectors(LidarSummary::SECTORS);
+    for (int i = 0; i < LidarSummary::SECTORS; i++) {
+        sectors[i] = decoder.getDistance(i);
+    }
+    view->setSectors(sectors);
+    scanCount++;
+}
+
+void LidarSummaryWidget::updateStatus()
+{
+    QString status = QString("%1 scans/s").arg(scanCount);
+    if (hasHealth) {
+        QStringList faults;
+        if (health.flags & LidarHealth::STALLED) faults << "stalled";
+        if (health.flags & LidarHealth::SLOW_ROTATION) faults << "rotation";
+        if (health.flags & LidarHealth::PACKET_LOSS) faults << "packet loss";
+        if (health.flags & LidarHealth::CRC_ERRORS) faults << "CRC";
+        if (health.flags & LidarHealth::ANGULAR_GAP) faults << "gaps";
+        status += QString(" | %1 Hz, %2 packets/s, %3 CRC errors/s, largest gap %4 deg | %5")
+            .arg(health.speed / 360.0, 0, 'f', 1)
+            .arg(health.packetRate)
+            .arg(health.crcErrorRate)
+            .arg(health.largestGap / 100.0, 0, 'f', 1)
+            .arg(faults.isEmpty() ? QString("healthy") : "degraded: " + faults.join(", "));
+    }
+    statusLabel->setText(status);
+    scanCount = 0;
+}
@@ -0,0 +1,101 @@
+#include "../include/lidarviewwidget.hpp"
+#include "LidarStream.hpp"
+#include <QPainter>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QtMath>
+
+static const double VIEW_RANGE = 4000.0;  // mm from the centre to the widget edge at zoom 1
+
+LidarViewWidget::LidarViewWidget(QWidget *parent)
+    : QWidget(parent), distances(BINS, 0), intensities(BINS, 0), zoom(1.0)
+{
+    setMinimumSize(300, 300);
+    setMouseTracking(false);
+}
+
+void LidarViewWidget::addBatch(const LidarPointBatch &batch)
+{
+    for (int i = 0; i < batch.count; i++) {
+        int bin = (batch.angles[i] / 50) % BINS;
+        distances[bin] = batch.distances[i];
+        intensities[bin] = batch.intensities[i];
+    }
+    update();
+}
+
+void LidarViewWidget::setSectors(const QVector<quint16> &sectorDistances)
+{
+    if (sectorDistances.isEmpty()) {
+        return;
+    }
+    // Spread each sector over its bins so it draws as an arc
+    for (int bin = 0; bin < BINS; bin++) {
+        distances[bin] = sectorDistances[bin * sectorDistances.size() / BINS];
+        intensities[bin] = 0;
+    }
+    update();
+}
+
+void LidarViewWidget::clear()
+{
+    distances.fill(0);
+    intensities.fill(0);
+    update();
+}
+
+void LidarViewWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    double scale = zoom * qMin(width(), height()) / (2.0 * VIEW_RANGE);  // Pixels per mm
+    painter.translate(width() / 2.0 + pan.x(), height() / 2.0 + pan.y());
+
+    // 1 m range rings
+    painter.setPen(QColor(40, 40, 40));
+    for (int ring = 1000; ring <= VIEW_RANGE; ring += 1000) {
+        painter.drawEllipse(QPointF(0, 0), ring * scale, ring * scale);
+    }
+
+    // LD06 angles are clockwise from forward: forward is up, clockwise is to the right
+    painter.setPen(Qt::NoPen);
+    for (int bin = 0; bin < BINS; bin++) {
+        if (distances[bin] == 0) {
+            continue;
+        }
+        double angle = qDegreesToRadians((bin + 0.5) * 0.5);
+        double d = distances[bin] * scale;
+        painter.setBrush(QColor(255 - intensities[bin], 255, 0));
+        painter.drawEllipse(QPointF(d * qSin(angle), -d * qCos(angle)), 2.0, 2.0);
+    }
+
+    // Sensor position
+    painter.setPen(QPen(Qt::red, 2));
+    painter.drawLine(QPointF(0, -10), QPointF(0, 10));
+    painter.drawLine(QPointF(-10, 0), QPointF(10, 0));
+}
+
+void LidarViewWidget::wheelEvent(QWheelEvent *event)
+{
+    double steps = event->angleDelta().y() / 120.0;
+    zoom = qBound(0.05, zoom * qPow(1.2, steps), 50.0);
+    update();
+}
+
+void LidarViewWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        lastMouse = event->pos();
+    }
+}
+
+void LidarViewWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (event->buttons() & Qt::LeftButton) {
+        pan += event->pos() - lastMouse;
+        lastMouse = event->pos();
+        update();
+    }
+}
@@ -11,12 +11,16 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     robotControlWidget = new RobotControlWidget(nullptr, this);
     magWidget = new MagnetometerWidget(nullptr, this);
     beaconControlWidget = new BeaconControlWidget(nullptr, this);
+    lidarRecorderWidget = new LidarRecorderWidget(this);
+    lidarSummaryWidget = new LidarSummaryWidget(nullptr, this);
 
     tabWidget->addTab(connectionWidget, "Connection");
     tabWidget->addTab(robotControlWidget, "Robot Control");
     tabWidget->addTab(magWidget, "Magnetometer");
     tabWidget->addTab(beaconControlWidget, "Beacon");
     tabWidget->addTab(ledControlWidget, "LED Control");
+    tabWidget->addTab(lidarSummaryWidget, "Lidar View");
+    tabWidget->addTab(lidarRecorderWidget, "Lidar");  // USB, usable without BLE
 
     setCentralWidget(tabWidget);
 
@@ -29,6 +33,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     tabWidget->setTabEnabled(tabWidget->indexOf(robotControlWidget), false);
     tabWidget->setTabEnabled(tabWidget->indexOf(magWidget), false);
     tabWidget->setTabEnabled(tabWidget->indexOf(beaconControlWidget), false);
+    tabWidget->setTabEnabled(tabWidget->indexOf(lidarSummaryWidget), false);
 
 
     setWindowTitle("SkyRocket");
@@ -51,11 +56,13 @@ void MainWindow::onConnected(QLowEnergyService *service)
     robotControlWidget->setService(service);
     magWidget->setService(service);
     beaconControlWidget->setService(service);
+    lidarSummaryWidget->setService(service);
 
     tabWidget->setTabEnabled(tabWidget->indexOf(ledControlWidget), true);
     tabWidget->setTabEnabled(tabWidget->indexOf(robotControlWidget), true);
     tabWidget->setTabEnabled(tabWidget->indexOf(magWidget), true);
     tabWidget->setTabEnabled(tabWidget->indexOf(beaconControlWidget), true);
+    tabWidget->setTabEnabled(tabWidget->indexOf(lidarSummaryWidget), true);
 
     tabWidget->setTabEnabled(tabWidget->indexOf(connectionWidget), false);
 
@@ -66,11 +73,13 @@ void MainWindow::onDisconnected()
 {
     ledControlWidget->setService(nullptr);
     robotControlWidget->setService(nullptr);
+    lidarSummaryWidget->setService(nullptr);
 
     tabWidget->setTabEnabled(tabWidget->indexOf(ledControlWidget), false);
     tabWidget->setTabEnabled(tabWidget->indexOf(robotControlWidget), false);
     tabWidget->setTabEnabled(tabWidget->indexOf(magWidget), false);
     tabWidget->setTabEnabled(tabWidget->indexOf(beaconControlWidget), false);
+    tabWidget->setTabEnabled(tabWidget->indexOf(lidarSummaryWidget), false);
 
     tabWidget->setTabEnabled(tabWidget->indexOf(connectionWidget), true);
     
@@ -0,0 +1,78 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  geometry_bench.cpp    */
+
+// LidarGeometry against libm: worst conversion error over every LD06 angle,
+// and the throughput of the batch kernel against a cosf/sinf loop.
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "LidarGeometry.hpp"
+
+static const int POINTS = 4500;  // One second of LD06 returns
+static const int ROUNDS = 2000;
+
+static void libmConvert(const uint16_t* angles, const uint16_t* distances, int16_t* x, int16_t* y, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float a = angles[i] * (float)(M_PI / 18000.0);
+        x[i] = (int16_t)(distances[i] * cosf(a));
+        y[i] = (int16_t)(-(distances[i] * sinf(a)));
+    }
+}
+
+template <typename Convert>
+static double measure(Convert convert, const uint16_t* angles, const uint16_t* distances, int16_t* x, int16_t* y, int rounds) {
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        convert(angles, distances, x, y, POINTS);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : ROUNDS;
+
+    // Accuracy of the Q15 sine and cosine over every 0.01 degree step
+    double worstSin = 0;
+    double worstCos = 0;
+    for (uint32_t angle = 0; angle < 36000; angle++) {
+        double radians = angle * M_PI / 18000.0;
+        worstSin = fmax(worstSin, fabs(LidarGeometry::sinQ15(angle) / (double)LidarGeometry::ONE - sin(radians)));
+        worstCos = fmax(worstCos, fabs(LidarGeometry::cosQ15(angle) / (double)LidarGeometry::ONE - cos(radians)));
+    }
+    printf("Q15 sine: max error %.2e, cosine: max error %.2e, %.1f mm at %d mm\n",
+           worstSin, worstCos, fmax(worstSin, worstCos) * 12000, 12000);
+
+    static uint16_t angles[POINTS];
+    static uint16_t distances[POINTS];
+    static int16_t x[POINTS], y[POINTS], refX[POINTS], refY[POINTS];
+    srand(1);
+    for (int i = 0; i < POINTS; i++) {
+        angles[i] = (uint16_t)(i * 8 % 36000);
+        distances[i] = (uint16_t)(60 + rand() % 12000);
+    }
+
+    libmConvert(angles, distances, refX, refY, POINTS);
+    LidarGeometry::polarToCartesian(angles, distances, x, y, POINTS);
+    int worst = 0;
+    for (int i = 0; i < POINTS; i++) {
+        worst = abs(x[i] - refX[i]) > worst ? abs(x[i] - refX[i]) : worst;
+        worst = abs(y[i] - refY[i]) > worst ? abs(y[i] - refY[i]) : worst;
+    }
+
+    double fixed = measure(LidarGeometry::polarToCartesian, angles, distances, x, y, rounds);
+    double libm = measure(libmConvert, angles, distances, refX, refY, rounds);
+    double points = (double)POINTS * rounds;
+    printf("polarToCartesian: %.1f Mpoints/s, libm: %.1f Mpoints/s, %.2fx, max difference %d mm\n",
+           points / fixed / 1e6, points / libm / 1e6, libm / fixed, worst);
+    return x[POINTS / 2] == 0 && y[POINTS / 2] == 0;  // Keeps the results alive
+}
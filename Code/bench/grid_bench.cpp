@@ -0,0 +1,80 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  grid_bench.cpp    */
+
+// Beam integration rate of OccupancyGrid on synthetic LD06 packets: a robot
+// driving across the table, returns on the table borders.
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "OccupancyGrid.hpp"
+
+static const int PACKETS_PER_TURN = 38;  // ~4500 points/s at 10 Hz
+static const int TURNS = 2000;
+
+// Distance from (x, y) along a heading (radians, counter-clockwise) to the table border
+static uint16_t borderDistance(float x, float y, float heading) {
+    float dx = cosf(heading);
+    float dy = sinf(heading);
+    float best = 1e9f;
+    if (dx > 1e-6f) best = fminf(best, (OccupancyGrid::TABLE_WIDTH - x) / dx);
+    if (dx < -1e-6f) best = fminf(best, -x / dx);
+    if (dy > 1e-6f) best = fminf(best, (OccupancyGrid::TABLE_HEIGHT - y) / dy);
+    if (dy < -1e-6f) best = fminf(best, -y / dy);
+    return (uint16_t)best;
+}
+
+int main(int argc, char** argv) {
+    int turns = argc > 1 ? atoi(argv[1]) : TURNS;
+    static OccupancyGrid grid;
+
+    // Packets are built ahead so only the grid is timed
+    static LidarPacket packets[PACKETS_PER_TURN];
+    uint32_t beams = 0;
+    double elapsed = 0;
+
+    for (int turn = 0; turn < turns; turn++) {
+        float x = 300.0f + 2400.0f * turn / turns;
+        float y = 1000.0f + 300.0f * sinf(turn * 0.01f);
+        int32_t heading = (turn * 50) % 36000;
+        float headingRad = heading * 0.01f * (float)M_PI / 180.0f;
+
+        for (int p = 0; p < PACKETS_PER_TURN; p++) {
+            LidarPacket& packet = packets[p];
+            packet.speed = 3600;
+            packet.startAngle = (uint16_t)(p * 36000 / PACKETS_PER_TURN);
+            packet.endAngle = (uint16_t)((p * 36000 / PACKETS_PER_TURN + 880) % 36000);
+            packet.timestamp = (uint16_t)((turn * 100 + p * 3) % 30000);
+            for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+                float angle = (packet.startAngle + 80.0f * i) * 0.01f * (float)M_PI / 180.0f;
+                packet.distances[i] = borderDistance(x, y, headingRad - angle);  // LD06 angles are clockwise
+                packet.intensities[i] = 200;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        grid.setPose((int32_t)x, (int32_t)y, heading);
+        for (int p = 0; p < PACKETS_PER_TURN; p++) {
+            grid.addPacket(packets[p]);
+        }
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        beams += PACKETS_PER_TURN * LidarFramer::POINTS_PER_PACKET;
+    }
+
+    int occupied = 0;
+    for (int i = 0; i < OccupancyGrid::WIDTH * OccupancyGrid::HEIGHT; i++) {
+        occupied += grid.getCells()[i] > 0;
+    }
+    printf("OccupancyGrid: %u beams in %.3f s, %.0f beams/s (LD06: 4500/s), %d occupied cells\n",
+           beams, elapsed, beams / elapsed, occupied);
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+
+/*  hedgehog_bench.cpp    */
+
+// Decoding rate of HedgehogFramer on a Marvelmind stream, either a raw UART
+// capture given as argument or a synthetic one: position and IMU datagrams
+// with line noise, false headers and corrupted CRCs in between. The stream is
+// fed in UART sized chunks like Hedgehog::update() does.
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "HedgehogFramer.hpp"
+
+static const int DATAGRAMS = 200000;
+static const int REPEATS = 20;
+static const size_t RX_CHUNK = 64;  // Bytes per read, the ESP32 UART FIFO size
+
+struct Counts {
+    uint32_t datagrams;
+    uint32_t payloadBytes;
+};
+
+static void onDatagram(uint16_t id, const uint8_t* payload, uint8_t size, void* context) {
+    Counts* counts = static_cast<Counts*>(context);
+    counts->datagrams++;
+    counts->payloadBytes += size;
+    (void)id;
+    (void)payload;
+}
+
+// Reference implementation, one bit at a time
+static uint16_t crc16Bitwise(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+static void appendDatagram(std::vector<uint8_t>& stream, uint16_t id, uint8_t size, bool corrupt) {
+    size_t start = stream.size();
+    stream.push_back((uint8_t)HedgehogFramer::HEADER);
+    stream.push_back((uint8_t)HedgehogFramer::SIGNATURE);
+    stream.push_back(id & 0xFF);
+    stream.push_back(id >> 8);
+    stream.push_back(size);
+    for (int i = 0; i < size; i++) {
+        stream.push_back(rand() & 0xFF);
+    }
+    uint16_t crc = crc16Bitwise(&stream[start], stream.size() - start);
+    if (corrupt) {
+        crc ^= 0x0100;
+    }
+    stream.push_back(crc & 0xFF);
+    stream.push_back(crc >> 8);
+}
+
+// Returns the number of valid datagrams written
+static uint32_t synthesize(std::vector<uint8_t>& stream, int datagrams) {
+    uint32_t valid = 0;
+    for (int n = 0; n < datagrams; n++) {
+        int kind = rand() % 100;
+        if (kind < 3) {
+            // Line noise, without header bytes so it cannot hide a datagram
+            int length = 1 + rand() % 16;
+            for (int i = 0; i < length; i++) {
+                stream.push_back(rand() % HedgehogFramer::HEADER);
+            }
+        } else if (kind < 5) {
+            // False header announcing more bytes than follow before the next datagram
+            stream.push_back((uint8_t)HedgehogFramer::HEADER);
+            stream.push_back((uint8_t)HedgehogFramer::SIGNATURE);
+            stream.push_back(0x11);
+            stream.push_back(0x00);
+            stream.push_back(200);
+        } else if (kind < 6) {
+            appendDatagram(stream, 0x0011, 0x16, true);
+        }
+        if (n % 10 == 9) {
+            appendDatagram(stream, 0x0003, 0x20, false);  // Raw IMU
+        } else {
+            appendDatagram(stream, 0x0011, 0x16, false);  // High resolution position
+        }
+        valid++;
+    }
+    return valid;
+}
+
+static bool readFile(const char* path, std::vector<uint8_t>& stream) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    uint8_t buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        stream.insert(stream.end(), buffer, buffer + length);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<uint8_t> stream;
+    uint32_t expected = 0;
+    if (argc > 1) {
+        if (!readFile(argv[1], stream)) {
+            fprintf(stderr, "hedgehog_bench: cannot read %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        srand(1);
+        expected = synthesize(stream, DATAGRAMS);
+    }
+
+    // The table CRC must match the bitwise one at every length and alignment
+    bool crcOk = true;
+    for (size_t length = 0; length <= (size_t)HedgehogFramer::MAX_FRAME_SIZE && length < stream.size(); length++) {
+        size_t offset = length % 7;
+        if (offset + length <= stream.size()
+            && HedgehogFramer::crc16(&stream[offset], length) != crc16Bitwise(&stream[offset], length)) {
+            crcOk = false;
+        }
+    }
+
+    HedgehogFramer framer;
+    Counts counts = {0, 0};
+    double elapsed = 0;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        framer.reset();
+        counts.datagrams = 0;
+        counts.payloadBytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < stream.size(); i += RX_CHUNK) {
+            size_t length = stream.size() - i < RX_CHUNK ? stream.size() - i : RX_CHUNK;
+            framer.parse(&stream[i], length, onDatagram, &counts);
+        }
+        elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Same table, timed alone over the whole stream
+    auto start = std::chrono::steady_clock::now();
+    uint16_t tableCrc = 0;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        tableCrc = HedgehogFramer::crc16(stream.data(), stream.size());
+    }
+    double crcElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    uint16_t bitwiseCrc = 0;
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        bitwiseCrc = crc16Bitwise(stream.data(), stream.size());
+    }
+    double bitwiseElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double megabytes = (double)stream.size() * REPEATS / 1e6;
+    printf("HedgehogFramer: %.1f MB/s, %.0f datagrams/s (hedgehog: ~16/s at 115200 bd)\n",
+           megabytes / elapsed, counts.datagrams * REPEATS / elapsed);
+    printf("  %u datagrams, %u CRC errors, %u resyncs in %zu bytes\n",
+           framer.getDatagramCount(), framer.getCrcErrors(), framer.getResyncs(), stream.size());
+    printf("  CRC16 table %.0f MB/s, bitwise %.0f MB/s\n", megabytes / crcElapsed, megabytes / bitwiseElapsed);
+
+    bool countOk = argc > 1 || counts.datagrams == expected;
+    if (!countOk) {
+        printf("  expected %u datagrams\n", expected);
+    }
+    crcOk = crcOk && tableCrc == bitwiseCrc;
+    if (!crcOk) {
+        printf("  CRC16 table differs from the bitwise reference\n");
+    }
+    bool pass = countOk && crcOk;
+    printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  scan_replay.cpp    */
+
+// Runs the ScanMatcher on a lidar recording, the same path as the robot:
+// LD06 packets -> LidarScanAssembler -> ScanMatcher::match per revolution.
+//
+//   scan_replay file.lds   Replays a raw-frame recording from the Qt Lidar tab
+//   scan_replay            Synthesizes a recording of a known motion, replays
+//                          it and fails if the odometry drifts from the truth
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "LidarScan.hpp"
+#include "LidarStream.hpp"
+#include "ScanMatcher.hpp"
+
+static const float ROOM_WIDTH = 3000.0f;  // mm, the table
+static const float ROOM_HEIGHT = 2000.0f;
+static const int PACKETS_PER_SECOND = 375;
+static const int SYNTHETIC_SECONDS = 5;
+
+// Synthetic motion: constant velocity in the world frame, counter-clockwise turn
+static const float START_X = 900.0f;
+static const float START_Y = 700.0f;
+static const float VELOCITY_X = 150.0f;   // mm/s
+static const float VELOCITY_Y = 60.0f;
+static const float TURN_RATE = 0.15f;     // rad/s
+
+struct Segment {
+    float x0, y0, x1, y1;
+};
+
+// Table borders and a few obstacles so translation along each wall is observable
+static const Segment SEGMENTS[] = {
+    {0, 0, ROOM_WIDTH, 0}, {ROOM_WIDTH, 0, ROOM_WIDTH, ROOM_HEIGHT},
+    {ROOM_WIDTH, ROOM_HEIGHT, 0, ROOM_HEIGHT}, {0, ROOM_HEIGHT, 0, 0},
+    {2200, 400, 2500, 400}, {2500, 400, 2500, 600}, {2500, 600, 2200, 600}, {2200, 600, 2200, 400},
+    {400, 1500, 700, 1300}, {1500, 1800, 1500, 2000},
+};
+
+struct Replay {
+    LidarScanAssembler scans;
+    ScanMatcher matcher;
+    uint32_t lastSequence = 0;
+    int matched = 0;
+    int revolutions = 0;
+    int skipped = 0;       // Batches that are not raw frames
+    double matchTime = 0;
+    bool verbose = false;
+};
+
+static void onBatch(const LidarPointBatch& batch, void* context) {
+    Replay& replay = *static_cast<Replay*>(context);
+    if (batch.count != LidarFramer::POINTS_PER_PACKET) {
+        replay.skipped++;  // Point batches drop the empty returns, packets cannot be rebuilt
+        return;
+    }
+
+    // A raw frame batch holds the interpolated angles: the ends give the packet back
+    LidarPacket packet;
+    packet.speed = batch.speed;
+    packet.timestamp = batch.timestamp;
+    packet.startAngle = batch.angles[0];
+    packet.endAngle = batch.angles[LidarFramer::POINTS_PER_PACKET - 1];
+    for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+        packet.distances[i] = batch.distances[i];
+        packet.intensities[i] = batch.intensities[i];
+    }
+    replay.scans.addPacket(packet);
+
+    if (replay.scans.getSequence() != replay.lastSequence) {
+        replay.lastSequence = replay.scans.getSequence();
+        replay.revolutions++;
+        auto start = std::chrono::steady_clock::now();
+        bool valid = replay.matcher.match(replay.scans.getScan());
+        replay.matchTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        replay.matched += valid;
+        if (replay.verbose) {
+            const ScanMatch& match = replay.matcher.getMatch();
+            printf("%5d %d dx %7.1f dy %7.1f dtheta %6.2f rms %5.1f n %3u | odometry %8.1f %8.1f %7.2f\n",
+                   replay.revolutions, valid, match.x, match.y, match.theta * 180 / M_PI, match.rms, match.correspondences,
+                   replay.matcher.getOdometryX(), replay.matcher.getOdometryY(), replay.matcher.getOdometryTheta() * 180 / M_PI);
+        }
+    }
+}
+
+static float castRay(float x, float y, float heading) {
+    float dx = cosf(heading);
+    float dy = sinf(heading);
+    float best = 0;
+    for (const Segment& segment : SEGMENTS) {
+        float ex = segment.x1 - segment.x0;
+        float ey = segment.y1 - segment.y0;
+        float denominator = dx * ey - dy * ex;
+        if (fabsf(denominator) < 1e-9f) {
+            continue;
+        }
+        float t = ((segment.x0 - x) * ey - (segment.y0 - y) * ex) / denominator;
+        float u = ((segment.x0 - x) * dy - (segment.y0 - y) * dx) / denominator;
+        if (t > 0 && u >= 0 && u <= 1 && (best == 0 || t < best)) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void pose(float time, float& x, float& y, float& heading) {
+    x = START_X + VELOCITY_X * time;
+    y = START_Y + VELOCITY_Y * time;
+    heading = TURN_RATE * time;
+}
+
+static void record(const uint8_t* data, size_t length, void* context) {
+    std::vector<uint8_t>& recording = *static_cast<std::vector<uint8_t>*>(context);
+    recording.insert(recording.end(), data, data + length);
+}
+
+// LD06 at 10 Hz, 4500 points/s, with 10 mm of range noise
+static std::vector<uint8_t> synthesize() {
+    std::vector<uint8_t> recording;
+    LidarStream stream(LidarStream::RAW);
+    stream.setWriter(record, &recording);
+    srand(1);
+
+    const int packets = PACKETS_PER_SECOND * SYNTHETIC_SECONDS;
+    const float step = 36000.0f / (PACKETS_PER_SECOND / 10.0f * LidarFramer::POINTS_PER_PACKET);  // 0.01 degrees per point
+    for (int p = 0; p < packets; p++) {
+        float start = fmodf(p * step * LidarFramer::POINTS_PER_PACKET, 36000.0f);
+        LidarPacket packet;
+        packet.speed = 3600;
+        packet.startAngle = (uint16_t)start;
+        packet.endAngle = (uint16_t)fmodf(start + step * (LidarFramer::POINTS_PER_PACKET - 1), 36000.0f);
+        float time = (float)p / PACKETS_PER_SECOND;
+        packet.timestamp = (uint16_t)((int)(time * 1000) % LidarScan::TIMESTAMP_WRAP);
+        for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+            float x, y, heading;
+            pose(time + i / (PACKETS_PER_SECOND * (float)LidarFramer::POINTS_PER_PACKET), x, y, heading);
+            float angle = LidarScanAssembler::pointAngle(packet, i) * 0.01f * (float)M_PI / 180.0f;
+            float distance = castRay(x, y, heading - angle);  // LD06 angles are clockwise
+            distance += (rand() % 21) - 10;
+            packet.distances[i] = distance > 0 ? (uint16_t)distance : 0;
+            packet.intensities[i] = 200;
+        }
+        stream.addPacket(packet);
+    }
+    return recording;
+}
+
+static void replay(const std::vector<uint8_t>& recording, Replay& result) {
+    LidarStreamDecoder decoder;
+    decoder.parse(recording.data(), recording.size(), onBatch, &result);
+}
+
+int main(int argc, char** argv) {
+    static Replay result;
+
+    if (argc > 1) {
+        FILE* file = fopen(argv[1], "rb");
+        if (!file) {
+            fprintf(stderr, "Cannot read %s\n", argv[1]);
+            return 2;
+        }
+        std::vector<uint8_t> recording;
+        uint8_t chunk[4096];
+        size_t length;
+        while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            recording.insert(recording.end(), chunk, chunk + length);
+        }
+        fclose(file);
+
+        result.verbose = true;
+        replay(recording, result);
+        printf("%d revolutions, %d matched, %d point batches skipped (record in raw mode), %.2f ms per match\n",
+               result.revolutions, result.matched, result.skipped, result.revolutions ? result.matchTime * 1000 / result.revolutions : 0);
+        return 0;
+    }
+
+    std::vector<uint8_t> recording = synthesize();
+    replay(recording, result);
+
+    // Truth: the sensor at the end of the last revolution in the frame of the
+    // sensor at the end of the first one, the reference the odometry starts from
+    int revolutions = result.revolutions;
+    float firstTime = result.scans.getScan().endTimestamp / 1000.0f - (revolutions - 1) * 0.1f;
+    float lastTime = result.scans.getScan().endTimestamp / 1000.0f;
+    float x0, y0, h0, x1, y1, h1;
+    pose(firstTime, x0, y0, h0);
+    pose(lastTime, x1, y1, h1);
+    float c = cosf(h0);
+    float s = sinf(h0);
+    float truthX = c * (x1 - x0) + s * (y1 - y0);
+    float truthY = -s * (x1 - x0) + c * (y1 - y0);
+    float truthTheta = h1 - h0;
+
+    float errorPosition = hypotf(result.matcher.getOdometryX() - truthX, result.matcher.getOdometryY() - truthY);
+    float errorTheta = fabsf(result.matcher.getOdometryTheta() - truthTheta) * 180 / (float)M_PI;
+    float travelled = hypotf(truthX, truthY);
+    printf("%d revolutions, %d matched, %.2f ms per match\n", revolutions, result.matched, result.matchTime * 1000 / revolutions);
+    printf("odometry %.1f %.1f %.2f deg, truth %.1f %.1f %.2f deg: %.1f mm (%.1f%%) and %.2f deg off\n",
+           result.matcher.getOdometryX(), result.matcher.getOdometryY(), result.matcher.getOdometryTheta() * 180 / M_PI,
+           truthX, truthY, truthTheta * 180 / M_PI, errorPosition, 100 * errorPosition / travelled, errorTheta);
+
+    bool pass = result.matched >= revolutions - 1 && errorPosition < 0.05f * travelled + 20 && errorTheta < 2.0f;
+    printf(pass ? "PASS\n" : "FAIL\n");
+    return pass ? 0 : 1;
+}
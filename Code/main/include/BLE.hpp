@@ -30,6 +30,8 @@ public:
     using CommandCallback = std::function<void(const uint8_t*, size_t)>;
     void setCommandCallback(CommandCallback callback);
 
+    bool notify(const uint8_t* data, size_t length);  // Telemetry characteristic, false if no client, safe from any task
+
 private:
     class MyServerCallbacks : public BLEServerCallbacks {
     public:
@@ -50,6 +52,8 @@ private:
 
     BLEServer* pServer_;
     BLECharacteristic* pCharacteristic_;
+    BLECharacteristic* pNotifyCharacteristic_;
+    SemaphoreHandle_t notifyMutex_;  // Keeps setValue() and notify() of one payload together
     bool isConnected_ = false;
     CommandCallback commandCallback_;
 };
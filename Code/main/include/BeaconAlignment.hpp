@@ -0,0 +1,70 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  BeaconAlignment.hpp    */
+
+#ifndef BEACONALIGNMENT_HPP
+#define BEACONALIGNMENT_HPP
+
+#include <stdint.h>
+
+struct BeaconAlignmentResult {
+    float angle;          // Degrees counter-clockwise in the beacon frame of robot forward, [0, 360)
+    float heading;        // Magnetometer heading the angle holds for, degrees
+    float distance;       // mm travelled along the fitted line
+    float residual;       // RMS distance of the kept fixes to the line, mm
+    float headingSpread;  // RMS deviation of the kept heading samples, degrees
+    uint8_t samples;
+    uint8_t inliers;
+};
+
+// Finds the beacon frame rotation from every fix taken while the robot drives
+// straight forward. Samples where the magnetometer saw the robot turn are
+// dropped, a consensus line through two fixes discards the jumps, then the
+// direction of travel is the principal axis of the remaining fixes, refitted
+// while fixes lie far from it by a robust estimate of the spread. The angle holds for the mean heading of the samples.
+class BeaconAlignment {
+public:
+    static const int MAX_SAMPLES = 32;
+    static const int ITERATIONS = 3;
+
+    BeaconAlignment();
+
+    bool addSample(float x, float y, float heading);  // mm, compass degrees. False once full
+    bool solve(BeaconAlignmentResult& result);        // False without enough travel or kept fixes
+    void reset();
+
+    int getCount() const { return count; }
+
+    void setMinDistance(float mm) { minDistance = mm; }
+    void setMinResidual(float mm) { minResidual = mm; }      // Fixes closer than this to the line are never dropped
+    void setMaxTurn(float degrees) { maxTurn = degrees; }    // Heading deviation that drops a sample
+    void setMinInliers(uint8_t samples) { minInliers = samples; }
+
+private:
+    struct Sample {
+        float x;
+        float y;
+        float heading;
+        bool inlier;
+    };
+
+    Sample samples[MAX_SAMPLES];
+    int count = 0;
+
+    float minDistance = 150.0f;
+    float minResidual = 30.0f;
+    float maxTurn = 5.0f;
+    uint8_t minInliers = 5;
+
+    int fit(float& cx, float& cy, float& ux, float& uy) const;  // Principal axis of the inliers, returns their count
+    bool consensus();  // Keeps the inliers near the two-fix line most of them agree with
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  BeaconPosts.hpp    */
+
+#ifndef BEACONPOSTS_HPP
+#define BEACONPOSTS_HPP
+
+#include <stdint.h>
+#include "LidarScan.hpp"
+#include "Seqlock.hpp"
+
+// Pose of the lidar on the table from the reflective beacon posts
+struct BeaconPose {
+    float x;          // mm, table frame
+    float y;          // mm
+    float theta;      // Degrees, counter-clockwise from table +x to sensor forward
+    float residual;   // RMS fit error, mm
+    uint8_t matched;  // Posts used in the fit
+    uint32_t sequence;   // Scan the pose comes from
+    uint32_t timestamp;  // ms, the time passed to detect()
+
+    uint32_t age(uint32_t now) const { return now - timestamp; }  // ms
+};
+
+// Finds high-intensity clusters in a LidarScan, matches them to the known
+// post positions by their pairwise distances and solves the rigid transform
+// between the two point sets. The pose is published as a whole, so any
+// task can read it while the scan task detects the next one.
+class BeaconPosts {
+public:
+    static const int MAX_POSTS = 4;
+    static const int MAX_CANDIDATES = 8;
+
+    enum Team : uint8_t {
+        BLUE = 0,
+        YELLOW,
+    };
+
+    BeaconPosts();
+
+    bool detect(const LidarScan& scan, uint32_t now);  // Returns true if a pose was triangulated
+
+    void setTeam(Team team);  // Moves the posts to that side, the previous pose no longer counts
+    Team getTeam() const { return team; }
+    void setPost(int index, float x, float y);
+    void setIntensityThreshold(uint8_t threshold) { intensityThreshold = threshold; }
+
+    bool isPoseValid() const { return poseValid; }  // The last detect() found a pose
+    bool getPose(BeaconPose& pose) const { return pose_.read(pose) && pose.matched != 0; }  // Last pose found, from any task
+    bool getFreshPose(BeaconPose& pose, uint32_t maxAge, uint32_t now) const { return poseValid && getPose(pose) && pose.age(now) <= maxAge; }
+    int getCandidateCount() const { return candidateCount; }
+
+private:
+    float postX[MAX_POSTS];
+    float postY[MAX_POSTS];
+    int postCount = 0;
+    Team team = BLUE;
+
+    float candidateX[MAX_CANDIDATES];  // Sensor frame (x forward, y left), mm
+    float candidateY[MAX_CANDIDATES];
+    int candidateCount = 0;
+
+    Seqlock<BeaconPose> pose_;
+    volatile bool poseValid = false;
+
+    uint8_t intensityThreshold = 180;
+    float postRadius = 40.0f;       // mm, reflector surface to post centre
+    float maxClusterWidth = 150.0f; // mm, wider bright objects are not posts
+    float matchTolerance = 80.0f;   // mm on pairwise distances
+    float maxResidual = 50.0f;      // mm
+
+    void cluster(const LidarScan& scan);
+    float solve(const int* assignment, int count, BeaconPose& result) const;
+};
+
+#endif
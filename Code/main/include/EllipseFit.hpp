@@ -0,0 +1,56 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  EllipseFit.hpp    */
+
+#ifndef ELLIPSEFIT_HPP
+#define ELLIPSEFIT_HPP
+
+#include <stdint.h>
+
+// Streaming least-squares fit of the ellipse traced by the horizontal
+// magnetometer axes while the robot turns. Each sample only updates the
+// normal equations of the conic A x^2 + B xy + C y^2 + D x + E y = 1, so no
+// samples are kept. The solution gives the hard iron offset (the centre) and
+// the soft iron correction (the matrix mapping the ellipse to a circle of the
+// same mean radius).
+class EllipseFit {
+public:
+    static const int TERMS = 5;
+
+    EllipseFit();
+
+    void add(float x, float y);
+    bool solve();   // False until the samples describe an ellipse
+    void reset();
+
+    // Valid after a successful solve()
+    float getCenterX() const { return centerX; }
+    float getCenterY() const { return centerY; }
+    const float* getMatrix() const { return matrix; }   // Row-major 2x2, applied after removing the centre
+    float getRadius() const { return radius; }          // Mean radius, same unit as the samples
+    float getResidual() const { return residual; }      // RMS radius error of the samples, fraction of the radius
+    float getCoverage() const { return coverage; }      // Degrees of arc the samples span, 0-360
+
+    uint32_t getCount() const { return count; }
+
+private:
+    double normal[TERMS][TERMS];  // Sum of phi phi^T, phi = (x^2, xy, y^2, x, y)
+    double moments[TERMS];        // Sum of phi
+    uint32_t count = 0;
+
+    float centerX = 0;
+    float centerY = 0;
+    float matrix[4] = {1, 0, 0, 1};
+    float radius = 0;
+    float residual = 0;
+    float coverage = 0;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  FixFilter.hpp    */
+
+#ifndef FIXFILTER_HPP
+#define FIXFILTER_HPP
+
+#include <stdint.h>
+
+// Rejects and smooths Marvelmind fixes. A fix is gated against the motion of
+// the accepted history: it must be reachable within the speed bound and stay
+// within the acceleration bound of a line fitted through the last accepted
+// fixes. The output is that Huber-weighted line evaluated at the new fix, so
+// it smooths the jitter without lagging a robot moving at constant speed.
+// Consistent rejections in a row mean the robot really is elsewhere: the
+// history restarts from there.
+class FixFilter {
+public:
+    static const int HISTORY = 8;
+    static const int TREND_FIXES = 5;        // Accepted fixes the line is fitted on
+    static const int RELOCK_COUNT = 3;       // Consistent rejections before restarting
+    static const uint32_t MAX_GAP = 2000;    // ms without fixes before the history is dropped
+
+    FixFilter();
+
+    // Returns false for a rejected fix. quality is 0-100 from the innovation,
+    // scaled by the source quality when the beacons report one (0 = unknown).
+    bool add(float x, float y, uint32_t time, uint8_t sourceQuality, float& filteredX, float& filteredY, uint8_t& quality);
+    void reset();
+
+    uint32_t getRejected() const { return rejected; }
+    uint32_t getRelocks() const { return relocks; }
+
+    void setMaxSpeed(float mmPerSecond) { maxSpeed = mmPerSecond; }
+    void setMaxAcceleration(float mmPerSecond2) { maxAcceleration = mmPerSecond2; }
+    void setNoise(float mm) { noise = mm; }
+
+private:
+    struct Sample {
+        uint32_t time;
+        float x;          // Accepted fix
+        float y;
+        float filteredX;  // Smoother output for that fix
+        float filteredY;
+    };
+
+    Sample history[HISTORY];
+    int head = 0;
+    int count = 0;
+
+    int consecutiveRejects = 0;
+    float rejectX = 0;    // Last rejected fix, to check rejections agree with each other
+    float rejectY = 0;
+    uint32_t rejectTime = 0;
+
+    uint32_t rejected = 0;
+    uint32_t relocks = 0;
+
+    float maxSpeed = 1500.0f;         // mm/s
+    float maxAcceleration = 2000.0f;  // mm/s^2
+    float noise = 60.0f;              // mm, beacon jitter allowance
+
+    const Sample& at(int age) const { return history[(head + HISTORY - 1 - age) % HISTORY]; }  // 0 = newest
+    bool trend(uint32_t time, float& x, float& y, float& vx, float& vy, float& span) const;  // Line through the recent fixes at time, span in s
+    void push(float x, float y, uint32_t time, float& filteredX, float& filteredY);
+};
+
+#endif
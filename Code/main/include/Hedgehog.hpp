@@ -13,6 +13,33 @@ _\ \   <| |_| / _  \ (_) | (__|   <  __/ |_
 #define HEDGEHOG_HPP
 
 #include <Arduino.h>
+#include "HedgehogFramer.hpp"
+#include "Seqlock.hpp"
+#include "FixFilter.hpp"
+
+// One position fix, published whole so x, y and z always come from the same datagram
+struct HedgehogFix {
+    int32_t x;           // mm
+    int32_t y;
+    int32_t z;
+    uint32_t timestamp;  // millis() when the datagram was received
+    uint32_t sequence;   // Counts fixes from 1, 0 = no fix yet
+    uint8_t quality;     // 0-100, from the outlier gate and the beacons' own quality
+
+    uint32_t age(uint32_t now) const { return now - timestamp; }  // ms
+};
+
+// Fused IMU output of the beacon system, published whole like HedgehogFix
+struct HedgehogImu {
+    float yaw;           // Degrees counter-clockwise in the beacon frame, [0, 360)
+    float qw, qx, qy, qz;
+    int16_t vx, vy, vz;  // mm/s
+    int16_t ax, ay, az;  // mm/s^2
+    uint32_t timestamp;  // millis() when the datagram was received
+    uint32_t sequence;   // Counts datagrams from 1, 0 = none yet
+
+    uint32_t age(uint32_t now) const { return now - timestamp; }  // ms
+};
 
 class Hedgehog {
 public:
@@ -20,13 +47,20 @@ public:
     ~Hedgehog();
 
     bool init();         // Initialize the Hedgehog
-    void update();       // Process incoming serial data
+    void update();       // Drain the UART ring buffer and decode every complete datagram
     void processData();  // Handle position data and update current coordinates
 
-    // Position data accessors
-    long getX() const { return hedgehog_x; }
-    long getY() const { return hedgehog_y; }
-    long getZ() const { return hedgehog_z; }
+    // Latest filtered fix, safe from any task. False if there is none yet or a write kept racing the read
+    bool getFix(HedgehogFix& fix) const { return fix_.read(fix) && fix.sequence != 0; }
+    bool getFreshFix(HedgehogFix& fix, uint32_t maxAge) const { return getFix(fix) && fix.age(millis()) <= maxAge; }
+
+    bool getRawFix(HedgehogFix& fix) const { return raw_.read(fix) && fix.sequence != 0; }  // Before the outlier gate
+    uint32_t getRejectedFixes() const { return filter.getRejected(); }
+
+    // Position data accessors, each call reads its own snapshot
+    long getX() const { HedgehogFix fix; return fix_.read(fix) ? fix.x : 0; }
+    long getY() const { HedgehogFix fix; return fix_.read(fix) ? fix.y : 0; }
+    long getZ() const { HedgehogFix fix; return fix_.read(fix) ? fix.z : 0; }
     bool isPositionUpdated() const { return hedgehog_pos_updated; }
 
     // IMU data accessors
@@ -38,8 +72,26 @@ public:
     int16_t getGyroZ() const { return imu_gyro_z; }
     int64_t getRawTimestamp() const { return imu_raw_timestamp; }
 
+    // Fused IMU: heading, velocity and acceleration at the beacon rate
+    bool getImu(HedgehogImu& imu) const { return imu_.read(imu) && imu.sequence != 0; }
+    bool getFreshImu(HedgehogImu& imu, uint32_t maxAge) const { return getImu(imu) && imu.age(millis()) <= maxAge; }
+
+    // Quality and telemetry
+    uint8_t getQuality() const { return quality; }                 // Percent, 0 until reported
+    uint8_t getQualityAddress() const { return qualityAddress; }   // Beacon the quality refers to
+    uint16_t getBatteryVoltage() const { return batteryVoltage; }  // mV
+    int8_t getRssi() const { return rssi; }                        // dBm
+
+    // Link statistics
+    uint32_t getDatagramCount() const { return framer.getDatagramCount(); }
+    uint32_t getCrcErrors() const { return framer.getCrcErrors(); }
+    uint32_t getRejectedDatagrams() const { return rejectedDatagrams; }  // Valid CRC but unknown ID or size
+
     void setAngle(float newAngle) { angle = newAngle; }  // Set the angle for PID control
+    void setAngle(float newAngle, float heading) { angle = newAngle; angleHeading = heading; aligned = true; }  // Angle measured at a magnetometer heading
     float getAngle() const { return angle; }  // Get the current angle
+    float getAngleHeading() const { return angleHeading; }
+    bool isAligned() const { return aligned; }  // The angle was calibrated with a heading
 
     void setTarget(int x, int y) { targetX = x; targetY = y; }  // Set target coordinates
     // Get target coordinates
@@ -61,6 +113,8 @@ private:
     HardwareSerial& serial;  // Reference to Serial port
 
     float angle = 0;  // Current angle between the robot and the x and y axis of the beacons
+    float angleHeading = 0;  // Magnetometer heading when the angle was calibrated
+    bool aligned = false;
     int targetX = 0;  // Target X coordinate
     int targetY = 0;  // Target Y coordinate
 
@@ -76,7 +130,11 @@ private:
     float correction = 0;
 
     // Position data
-    long hedgehog_x, hedgehog_y, hedgehog_z;
+    Seqlock<HedgehogFix> fix_;  // Filtered
+    Seqlock<HedgehogFix> raw_;
+    FixFilter filter;
+    uint32_t fixCount = 0;
+    uint32_t rawCount = 0;
     int hedgehog_pos_updated;
 
     // IMU data
@@ -84,40 +142,50 @@ private:
     int16_t imu_gyro_x, imu_gyro_y, imu_gyro_z;
     int64_t imu_raw_timestamp;
 
-    // Buffer and packet handling
-    static const byte HEDGEHOG_BUF_SIZE = 80;
-    static const byte HEDGEHOG_CM_DATA_SIZE = 0x10;
-    static const byte HEDGEHOG_MM_DATA_SIZE = 0x16;
-    static const byte HEDGEHOG_RAW_IMU_DATA_SIZE = 0x20;
-    byte hedgehog_serial_buf[HEDGEHOG_BUF_SIZE];
-    byte hedgehog_serial_buf_ofs;
-
-    // Datagram IDs
-    static const unsigned int POSITION_DATAGRAM_ID = 0x0001;
-    static const unsigned int POSITION_DATAGRAM_HIGHRES_ID = 0x0011;
-    static const unsigned int RAW_IMU_DATAGRAM_ID = 0x0003;
-    static const unsigned int NT_POSITION_DATAGRAM_HIGHRES_ID = 0x0081;
-    static const unsigned int NT_RAW_IMU_DATAGRAM_ID = 0x0083;
-    unsigned int hedgehog_data_id;
-
-    // Unions for data parsing
-    union uni_8x2_16 {
-        byte b[2];
-        unsigned int w;
-        int wi;
+    // Fused IMU, quality and telemetry
+    Seqlock<HedgehogImu> imu_;
+    uint32_t imuCount = 0;
+    uint8_t quality = 0;
+    uint8_t qualityAddress = 0;
+    uint16_t batteryVoltage = 0;
+    int8_t rssi = 0;
+    uint32_t rejectedDatagrams = 0;
+
+    // UART and framing
+    static const int RX_BUFFER_SIZE = 1024;  // ~90 ms of data at 115200 baud
+    static const int RX_CHUNK_SIZE = 128;
+    HedgehogFramer framer;
+    byte rxChunk[RX_CHUNK_SIZE];
+
+    // Datagram IDs, the NT variants carry 64-bit timestamps
+    static const uint16_t POSITION_DATAGRAM_ID = 0x0001;
+    static const uint16_t POSITION_DATAGRAM_HIGHRES_ID = 0x0011;
+    static const uint16_t RAW_IMU_DATAGRAM_ID = 0x0003;
+    static const uint16_t FUSED_IMU_DATAGRAM_ID = 0x0005;
+    static const uint16_t TELEMETRY_DATAGRAM_ID = 0x0006;
+    static const uint16_t QUALITY_DATAGRAM_ID = 0x0007;
+    static const uint16_t NT_POSITION_DATAGRAM_HIGHRES_ID = 0x0081;
+    static const uint16_t NT_RAW_IMU_DATAGRAM_ID = 0x0083;
+    static const uint16_t NT_FUSED_IMU_DATAGRAM_ID = 0x0085;
+
+    // One row per datagram type: accepted payload sizes and the decoder
+    typedef void (*Decoder)(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size);
+    struct DatagramType {
+        uint16_t id;
+        uint8_t minSize;
+        uint8_t maxSize;
+        Decoder decode;
     };
-    union uni_8x4_32 {
-        byte b[4];
-        float f;
-        unsigned long v32;
-        long vi32;
-    };
-    union uni_8x8_64 {
-        byte b[8];
-        int64_t vi64;
-    };
-
-    void setCrc16(byte* buf, byte size);  // CRC calculation
+    static const DatagramType DATAGRAM_TYPES[];
+
+    static void onDatagram(uint16_t id, const uint8_t* payload, uint8_t size, void* context);
+    static void decodePositionCm(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size);
+    static void decodePositionMm(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size);
+    static void decodeRawImu(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size);
+    static void decodeFusedImu(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size);
+    static void decodeTelemetry(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size);
+    static void decodeQuality(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size);
+    void publishFix(HedgehogFix& fix);  // Stamps and publishes, only from update()
 };
 
 #endif
\ No newline at end of file
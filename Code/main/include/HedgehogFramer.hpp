@@ -0,0 +1,60 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  HedgehogFramer.hpp    */
+
+#ifndef HEDGEHOGFRAMER_HPP
+#define HEDGEHOGFRAMER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Byte-stream framer for Marvelmind datagrams:
+//   0xFF | 0x47 | id (uint16 LE) | size | payload[size] | CRC16 Modbus (LE)
+// Like LidarFramer it does not depend on Arduino, keeps a partial datagram
+// between calls and never limits how many bytes one call consumes.
+class HedgehogFramer {
+public:
+    typedef void (*DatagramHandler)(uint16_t id, const uint8_t* payload, uint8_t size, void* context);
+
+    static const uint8_t HEADER = 0xFF;
+    static const uint8_t SIGNATURE = 0x47;
+    static const int HEADER_SIZE = 5;
+    static const int FRAME_OVERHEAD = HEADER_SIZE + 2;
+    static const int MAX_FRAME_SIZE = FRAME_OVERHEAD + 255;
+
+    HedgehogFramer();
+
+    // Parse every complete datagram in data (plus any partial one kept from the
+    // previous call), returns the number of valid datagrams
+    size_t parse(const uint8_t* data, size_t length, DatagramHandler handler, void* context);
+    void reset();
+
+    uint32_t getDatagramCount() const { return datagramCount; }
+    uint32_t getCrcErrors() const { return crcErrors; }
+    uint32_t getResyncs() const { return resyncs; }
+
+    static uint16_t crc16(const uint8_t* data, size_t length);  // Modbus, 0 over a datagram with its CRC
+
+private:
+    uint8_t frame[MAX_FRAME_SIZE];  // Partial datagram carried between calls
+    uint16_t frameLength;
+    bool hunting;                   // True while discarding bytes to find a header
+
+    uint32_t datagramCount;
+    uint32_t crcErrors;
+    uint32_t resyncs;
+
+    bool validate(const uint8_t* candidate, size_t size);  // Checks the signature and CRC, updates counters
+    void consume(DatagramHandler handler, void* context, size_t& datagrams);  // Empties complete datagrams out of frame
+    void skip();                                           // Counts a resync once per lost sync
+    void realign(uint16_t from);                           // Drops bytes up to the next header at or after from
+};
+
+#endif
@@ -13,6 +13,14 @@ _\ \   <| |_| / _  \ (_) | (__|   <  __/ |_
 #define LIDAR_HPP
 
 #include <Arduino.h>
+#include "LidarFramer.hpp"
+#include "LidarScan.hpp"
+#include "LidarSectors.hpp"
+#include "LidarFilter.hpp"
+#include "LidarHealth.hpp"
+
+// Lidar/Code/lidar_stream builds a copy of this driver, a new dependency of
+// Lidar.cpp goes in the list of its sync_driver.sh
 
 class Lidar {
 public:
@@ -20,39 +28,66 @@ public:
     ~Lidar();
 
     bool init();  // Initialize the LIDAR
-    bool update(); // Process LIDAR data, returns true if valid packet processed
+    bool update(); // Drain the UART ring buffer, returns true if at least one valid packet was processed
+
+    // Data accessors (last packet)
+    uint16_t getSpeed() const { return packet.speed; }
+    float getStartAngle() const { return packet.startAngle * 0.01f; }  // Degrees
+    float getEndAngle() const { return packet.endAngle * 0.01f; }      // Degrees
+    uint16_t getTimestamp() const { return packet.timestamp; }
+    uint16_t getDistance(int index) const { return (index >= 0 && index < 12) ? packet.distances[index] : 0; }
+    byte getIntensity(int index) const { return (index >= 0 && index < 12) ? packet.intensities[index] : 0; }
+
+    // Obstacle queries (robot frame, degrees), O(1) per call
+    uint16_t nearestInCone(float heading, float halfWidth) const { return sectors.nearest(heading, halfWidth); }
+    bool tooClose(float heading, float halfWidth);
+    uint8_t getConfidence(float angle) const { return filter.getConfidenceAt((uint16_t)fmodf(angle * 100.0f + 36000.0f, 36000.0f)); }  // Sensor degrees
+    uint32_t getRejectedPoints() const { return filter.getRejected(); }
+
+    // Full revolutions
+    const LidarScan& getScan() const { return scans.getScan(); }  // Valid until the next revolution completes
+    uint32_t getScanSequence() const { return scans.getSequence(); }
+    unsigned long getScanTime() const { return scanTime; }  // millis() when the last revolution was published
+
+    void setMountAngle(float degrees) { sectors.setMountAngle(degrees); }  // Sensor 0 degrees relative to robot forward
+
+    // Link statistics
+    uint32_t getFrameCount() const { return framer.getFrameCount(); }
+    uint32_t getCrcErrors() const { return framer.getCrcErrors(); }
+    uint32_t getResyncs() const { return framer.getResyncs(); }
+    uint16_t getFramesPerSecond() const { return health.getReport().packetRate; }
+
+    // Rotation, packet rate, CRC failures and angular gaps over the last second
+    const LidarHealth& getHealth() const { return health; }
+    bool isDegraded() const { return health.isDegraded(); }
 
-    // Data accessors
-    uint16_t getSpeed() const { return speed; }
-    float getStartAngle() const { return startAngle * 0.01f; }  // Degrees
-    float getEndAngle() const { return endAngle * 0.01f; }      // Degrees
-    uint16_t getTimestamp() const { return timestamp; }
-    uint16_t getDistance(int index) const { return (index >= 0 && index < 12) ? distances[index] : 0; }
-    byte getIntensity(int index) const { return (index >= 0 && index < 12) ? intensities[index] : 0; }
-    bool tooClose();
+    // Called from update() for every decoded packet, before the outlier filter
+    void setPacketListener(LidarFramer::PacketHandler handler, void* context) { listener = handler; listenerContext = context; }
 
 private:
     HardwareSerial& serial;  // Reference to Serial port
     int rxPin;              // RX pin for serial communication
 
     // LIDAR data
-    uint16_t speed;
-    uint16_t startAngle;
-    uint16_t endAngle;
-    uint16_t timestamp;
-    uint16_t distances[12];  // 12 distance points
-    byte intensities[12];    // 12 intensity points
+    LidarPacket packet;      // Last valid packet
+    LidarScanAssembler scans;
+    LidarSectors sectors;
+    LidarFilter filter;      // Gates what reaches the sectors and the revolutions
+    LidarFramer::PacketHandler listener = nullptr;
+    void* listenerContext = nullptr;
     float minValidDist = 60.0f; 
     float thresholdDist = 200.0f; 
 
-    // Buffer and constants
-    static const int BUFFER_SIZE = 47;  // 2 header + 43 data + 2 CRC
-    byte buffer[BUFFER_SIZE];
+    // UART and framing
+    static const int RX_BUFFER_SIZE = 4096;  // IDF ring buffer, ~230 ms of data at 230400 baud
+    static const int RX_CHUNK_SIZE = 256;
+    LidarFramer framer;
+    byte rxChunk[RX_CHUNK_SIZE];
 
-    // CRC table
-    static const uint8_t CrcTable[256];
+    LidarHealth health;
+    unsigned long scanTime = 0;
 
-    uint8_t calculateCrc8(uint8_t* data, uint8_t len);  // CRC calculation
+    static void onPacket(const LidarPacket& packet, void* context);
 };
 
 #endif
\ No newline at end of file
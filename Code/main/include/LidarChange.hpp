@@ -0,0 +1,53 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarChange.hpp    */
+
+#ifndef LIDARCHANGE_HPP
+#define LIDARCHANGE_HPP
+
+#include <stdint.h>
+#include "LidarScan.hpp"
+
+// Flags the 5 degree sectors of a LidarScan that differ from a reference
+// revolution. A sector changes when enough of its bins moved by more than
+// the sensor noise; only changed sectors refresh their reference, so a slow
+// drift still trips the detector once it adds up. Bins without a return
+// carry no information and are ignored.
+class LidarChange {
+public:
+    static const int SECTORS = 72;
+    static const int SECTOR_BINS = LidarScan::BINS / SECTORS;
+    static const int MASK_WORDS = (SECTORS + 31) / 32;
+
+    LidarChange();
+
+    int update(const LidarScan& scan);  // Returns the number of changed sectors
+    void reset();                       // Next update flags every sector
+
+    bool anyChanged() const { return changedCount > 0; }
+    bool isChanged(int sector) const { return (mask[sector >> 5] >> (sector & 31)) & 1; }
+    int getChangedCount() const { return changedCount; }
+    const uint32_t* getMask() const { return mask; }
+
+    void setTolerance(uint16_t mm, uint8_t percent) { minTolerance = mm; relativeTolerance = percent; }
+    void setMinBins(uint8_t bins) { minBins = bins; }
+
+private:
+    uint16_t reference[LidarScan::BINS];
+    uint32_t mask[MASK_WORDS];
+    int changedCount = 0;
+    bool primed = false;
+
+    uint16_t minTolerance = 30;    // mm
+    uint8_t relativeTolerance = 3; // Percent of the distance
+    uint8_t minBins = 2;           // Moved bins for a sector to count as changed
+};
+
+#endif
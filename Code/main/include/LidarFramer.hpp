@@ -0,0 +1,69 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarFramer.hpp    */
+
+#ifndef LIDARFRAMER_HPP
+#define LIDARFRAMER_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+// One decoded LD06 packet (12 points between startAngle and endAngle)
+struct LidarPacket {
+    uint16_t speed;           // Rotation speed, degrees per second
+    uint16_t startAngle;      // 0.01 degrees
+    uint16_t endAngle;        // 0.01 degrees
+    uint16_t timestamp;       // ms, wraps at 30000
+    uint16_t distances[12];   // mm
+    uint8_t intensities[12];
+};
+
+// Byte-stream framer for the LD06 protocol. It does not depend on Arduino so the
+// same parser runs on the robot and on the host against recorded streams.
+class LidarFramer {
+public:
+    typedef void (*PacketHandler)(const LidarPacket& packet, void* context);
+
+    static const int FRAME_SIZE = 47;        // 2 header + 43 data + 2 CRC
+    static const int POINTS_PER_PACKET = 12;
+    static const uint8_t HEADER = 0x54;
+    static const uint8_t VER_LEN = 0x2C;
+
+    LidarFramer();
+
+    // Parse every complete frame contained in data (plus any partial frame kept
+    // from the previous call). Never blocks, returns the number of valid frames.
+    size_t parse(const uint8_t* data, size_t length, PacketHandler handler, void* context);
+    void reset();
+
+    uint32_t getFrameCount() const { return frameCount; }
+    uint32_t getCrcErrors() const { return crcErrors; }
+    uint32_t getResyncs() const { return resyncs; }
+
+    static uint8_t crc8(const uint8_t* data, size_t length);
+    static void decode(const uint8_t* frame, LidarPacket& packet);
+
+private:
+    uint8_t frame[FRAME_SIZE];  // Partial frame carried between calls
+    uint8_t frameLength;
+    bool hunting;               // True while discarding bytes to find a header
+
+    uint32_t frameCount;
+    uint32_t crcErrors;
+    uint32_t resyncs;
+
+    static const uint8_t CrcTable[256];
+
+    bool validate(const uint8_t* candidate);  // Checks VerLen and CRC, updates counters
+    void skip();                               // Counts a resync once per lost sync
+    void realign();                            // Drops the buffered header and finds the next one
+};
+
+#endif
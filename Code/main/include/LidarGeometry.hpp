@@ -0,0 +1,92 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarGeometry.hpp    */
+
+#ifndef LIDARGEOMETRY_HPP
+#define LIDARGEOMETRY_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LidarFramer.hpp"
+#include "LidarScan.hpp"
+
+// Fixed-point trigonometry on LD06 angles (0.01 degrees) and batch
+// polar-to-Cartesian conversion. Output frame: x forward, y left, mm.
+namespace LidarGeometry {
+
+    static const int TABLE_BITS = 8;
+    static const int TABLE_SIZE = 1 << TABLE_BITS;  // Entries per quarter wave
+    static const int ONE = 1 << 15;                 // Q15 unit
+
+    // sin over [0, 90] degrees in Q15, last entry is sin(90). Stored as int32
+    // so the host compiler can use 32-bit gathers when vectorizing.
+    struct SineTable {
+        int32_t values[TABLE_SIZE + 1];
+    };
+
+    // Built at compile time with a Taylor series, no libm involved. The loops
+    // in a constexpr function need C++14 or later.
+    constexpr SineTable makeSineTable() {
+        SineTable table = {};
+        for (int i = 0; i <= TABLE_SIZE; i++) {
+            double x = 1.5707963267948966 * i / TABLE_SIZE;
+            double term = x;
+            double sum = x;
+            for (int n = 1; n < 12; n++) {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            double scaled = sum * (ONE - 1) + 0.5;
+            table.values[i] = (int32_t)scaled;
+        }
+        return table;
+    }
+
+    constexpr SineTable SINE = makeSineTable();
+
+    // 0.01 degrees to a 16-bit phase (65536 per turn), angle must be < 36000
+    inline int32_t phase(uint32_t angle) {
+        return (int32_t)((angle * 119305u) >> 16);
+    }
+
+    // Q15 sine of a 16-bit phase, linear interpolation between table entries.
+    // Quadrant folding is done with masks instead of branches.
+    inline int32_t sinPhase(int32_t phase) {
+        int32_t quadrant = (phase >> 14) & 3;
+        int32_t offset = phase & 0x3FFF;
+        int32_t mirror = -(quadrant & 1);
+        offset = (offset ^ mirror) + (0x4001 & mirror);  // 0x4000 - offset on odd quadrants
+        int32_t index = offset >> (14 - TABLE_BITS);
+        int32_t weight = offset & ((1 << (14 - TABLE_BITS)) - 1);
+        int32_t a = SINE.values[index];
+        int32_t b = SINE.values[index + (index < TABLE_SIZE)];
+        int32_t value = a + (((b - a) * weight) >> (14 - TABLE_BITS));
+        int32_t sign = -((quadrant >> 1) & 1);
+        return (value ^ sign) - sign;
+    }
+
+    inline int32_t sinQ15(uint32_t angle) { return sinPhase(phase(angle)); }
+    inline int32_t cosQ15(uint32_t angle) { return sinPhase(phase(angle) + 0x4000); }
+
+    // Struct-of-arrays kernel, branch free so it vectorizes on the host.
+    // LD06 angles are clockwise: x = d cos(a), y = -d sin(a).
+    void polarToCartesian(const uint16_t* angles, const uint16_t* distances, int16_t* x, int16_t* y, size_t count);
+
+    void convertPacket(const LidarPacket& packet, int16_t* x, int16_t* y);  // 12 points
+    void convertScan(const LidarScan& scan, int16_t* x, int16_t* y);        // LidarScan::BINS points, bin centres
+
+    // convertScan with every point moved into the sensor pose at the end of the
+    // revolution, from the per-bin offsets and a constant velocity (mm/s and
+    // rad/s counter-clockwise, sensor frame). One pass, no buffers.
+    void deskewScan(const LidarScan& scan, float vx, float vy, float omega, int16_t* x, int16_t* y);
+
+}
+
+#endif
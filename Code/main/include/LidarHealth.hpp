@@ -0,0 +1,96 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarHealth.hpp    */
+
+#ifndef LIDARHEALTH_HPP
+#define LIDARHEALTH_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LidarFramer.hpp"
+
+// Statistics of the last one second window
+struct LidarHealthReport {
+    uint16_t speed;         // Mean rotation speed, degrees per second
+    uint16_t packetRate;    // Valid packets per second
+    uint16_t crcErrorRate;  // CRC failures per second
+    uint16_t largestGap;    // Widest angle without points, 0.01 degrees
+    uint8_t gaps;           // Gaps wider than a missing packet, saturates at 255
+    uint8_t flags;          // LidarHealth::Fault bits
+};
+
+// Watches the LD06 link: rotation speed, packet rate against the sensor's
+// fixed 4500 samples per second, CRC failures and the angular gaps left by
+// lost packets. Faults are raised as soon as a window shows them, or at once
+// when packets stop, and clear after a clean window.
+class LidarHealth {
+public:
+    static const uint16_t NOMINAL_SPEED = 3600;        // Degrees per second, 10 Hz
+    static const uint16_t EXPECTED_PACKET_RATE = 375;  // 4500 samples/s, 12 per packet
+    static const uint16_t GAP_THRESHOLD = 200;         // 0.01 degrees, about three point steps
+    static const int REPORT_SIZE = 10;                 // Encoded bytes
+
+    enum Fault : uint8_t {
+        SLOW_ROTATION = 1 << 0,  // Also set when it spins too fast
+        PACKET_LOSS = 1 << 1,
+        CRC_ERRORS = 1 << 2,
+        ANGULAR_GAP = 1 << 3,
+        STALLED = 1 << 4,        // No packets at all
+    };
+
+    LidarHealth();
+
+    void addPacket(const LidarPacket& packet);
+    void update(unsigned long now, uint32_t frames, uint32_t crcErrors);  // Call often, closes a window every second
+    void begin(unsigned long now);  // Starts the first window, the frame counters must be at zero
+
+    const LidarHealthReport& getReport() const { return report; }
+    uint8_t getFlags() const { return report.flags; }
+    bool isDegraded() const { return report.flags != 0; }
+    bool isStalled() const { return report.flags & STALLED; }
+    uint32_t getRevolutions() const { return revolutions; }
+
+    void encode(uint8_t* out) const;  // REPORT_SIZE bytes, little endian
+    static bool decode(const uint8_t* data, size_t length, LidarHealthReport& report);
+
+    void setSpeedTolerance(uint8_t percent) { speedTolerance = percent; }
+    void setMinPacketRatio(uint8_t percent) { minPacketRatio = percent; }
+    void setMaxCrcErrorRate(uint16_t perSecond) { maxCrcErrorRate = perSecond; }
+    void setMaxGap(uint16_t centidegrees) { maxGap = centidegrees; }
+    void setStallTimeout(unsigned long ms) { stallTimeout = ms; }
+
+private:
+    LidarHealthReport report = {};
+
+    // Current window
+    unsigned long windowStart = 0;
+    uint32_t windowFrames = 0;
+    uint32_t windowCrcErrors = 0;
+    uint32_t speedSum = 0;
+    uint16_t speedCount = 0;
+    uint16_t windowLargestGap = 0;
+    uint8_t windowGaps = 0;
+
+    uint16_t lastStartAngle = 0;
+    uint16_t lastEndAngle = 0;
+    bool hasLast = false;
+    uint32_t revolutions = 0;
+
+    unsigned long lastFrameTime = 0;
+    uint32_t lastFrames = 0;
+
+    uint8_t speedTolerance = 20;       // Percent of NOMINAL_SPEED
+    uint8_t minPacketRatio = 85;       // Percent of EXPECTED_PACKET_RATE
+    uint16_t maxCrcErrorRate = 5;      // Per second
+    uint16_t maxGap = 1500;            // 0.01 degrees, about two packets in a row
+    unsigned long stallTimeout = 200;  // ms
+};
+
+#endif
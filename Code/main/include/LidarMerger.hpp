@@ -0,0 +1,50 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarMerger.hpp    */
+
+#ifndef LIDARMERGER_HPP
+#define LIDARMERGER_HPP
+
+#include <stdint.h>
+#include "LidarScan.hpp"
+
+// Merges the scans of several LD06 units into one robot-frame LidarScan.
+// Every return is moved through its sensor's mounting transform and binned
+// again around the robot origin, keeping the nearest per bin. The sensors'
+// own clocks are unrelated, so timestamps are rebuilt on the host clock:
+// the merged start/end timestamps are millis() modulo 30 s and the per-bin
+// offsets are relative to the earliest source.
+class LidarMerger {
+public:
+    static const int MAX_SENSORS = 2;
+
+    LidarMerger();
+
+    // Sensor position (mm, x forward, y left) and rotation of its 0 degree
+    // direction, degrees clockwise like the LD06
+    void setMount(int sensor, float x, float y, float angle);
+
+    // ends[i] is the host time (ms) at which scans[i] was published
+    void merge(const LidarScan* const* scans, const unsigned long* ends, int count);
+
+    const LidarScan& getScan() const { return merged; }
+
+private:
+    struct Mount {
+        float x;
+        float y;
+        float angle;  // 0.01 degrees
+    };
+
+    Mount mounts[MAX_SENSORS];
+    LidarScan merged;
+};
+
+#endif
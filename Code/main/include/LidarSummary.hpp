@@ -0,0 +1,67 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarSummary.hpp    */
+
+#ifndef LIDARSUMMARY_HPP
+#define LIDARSUMMARY_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LidarScan.hpp"
+
+// Per-revolution summary for BLE: the nearest return of each 5 degree sector,
+// one byte per sector in RESOLUTION mm steps, split into notifications that
+// fit the default 20-byte ATT payload:
+//   sequence (uint8) | index << 4 | count | SECTORS_PER_CHUNK sector bytes
+// 4 notifications per revolution, about 460 B/s at the default 200 ms interval.
+class LidarSummary {
+public:
+    static const int SECTORS = 72;
+    static const int SECTOR_BINS = LidarScan::BINS / SECTORS;
+    static const int RESOLUTION = 25;        // mm per step, 254 steps = 6.35 m
+    static const uint8_t NO_RETURN = 255;
+    static const int SECTORS_PER_CHUNK = 18;
+    static const int CHUNK_HEADER = 2;
+    static const int CHUNK_SIZE = CHUNK_HEADER + SECTORS_PER_CHUNK;
+    static const int CHUNKS = SECTORS / SECTORS_PER_CHUNK;
+
+    LidarSummary();
+
+    bool encode(const LidarScan& scan, unsigned long now);  // False while rate limited
+
+    int getChunkCount() const { return CHUNKS; }
+    const uint8_t* getChunk(int index) const { return chunks[index]; }
+
+    void setInterval(unsigned long ms) { interval = ms; }
+
+private:
+    uint8_t chunks[CHUNKS][CHUNK_SIZE];
+    uint8_t sequence = 0;
+    unsigned long interval = 200;  // ms between summaries
+    unsigned long lastTime = 0;
+    bool sent = false;
+};
+
+// Reassembles the chunks on the receiving side
+class LidarSummaryDecoder {
+public:
+    LidarSummaryDecoder();
+
+    bool addChunk(const uint8_t* data, size_t length);  // True when a full revolution is in
+    uint16_t getDistance(int sector) const;              // mm, 0 = no return
+    uint8_t getSequence() const { return sequence; }
+
+private:
+    uint8_t sectors[LidarSummary::SECTORS];
+    uint8_t sequence;
+    uint8_t received;  // Bit per chunk of the current sequence
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LineExtractor.hpp    */
+
+#ifndef LINEEXTRACTOR_HPP
+#define LINEEXTRACTOR_HPP
+
+#include <stdint.h>
+#include "LidarScan.hpp"
+#include "Seqlock.hpp"
+
+// A straight wall seen in one revolution, sensor frame (x forward, y left)
+struct LineSegment {
+    float startX, startY;  // mm
+    float endX, endY;      // mm
+    float angle;           // Direction in radians, [0, pi)
+    float length;          // mm
+    uint16_t points;
+};
+
+// Heading from the walls of one revolution, published whole so the valid flag
+// and the time always go with the heading they describe
+struct WallHeading {
+    float heading;       // Degrees [0, 90), clockwise like Magnetometer::getHeading()
+    bool valid;
+    uint32_t sequence;   // Counts extractions from 1, 0 = none yet
+    uint32_t timestamp;  // ms, the time passed to extract()
+
+    uint32_t age(uint32_t now) const { return now - timestamp; }  // ms
+    float resolve(float reference) const;  // heading + k * 90 closest to reference, [0, 360)
+};
+
+// Split-and-merge line extraction on a full LidarScan. The table borders are
+// perpendicular, so the wall directions give the robot heading relative to
+// the table modulo 90 degrees.
+class LineExtractor {
+public:
+    static const int MAX_SEGMENTS = 16;
+
+    LineExtractor();
+
+    int extract(const LidarScan& scan, uint32_t now);  // Returns the number of segments found
+
+    int getSegmentCount() const { return segmentCount; }
+    const LineSegment& getSegment(int index) const { return segments[index]; }
+
+    // Heading relative to the table walls in degrees [0, 90), clockwise like a
+    // compass so it turns the same way as Magnetometer::getHeading(). These
+    // two are for the task calling extract()
+    bool isHeadingValid() const { return headingValid; }
+    float getHeading() const { return heading; }
+
+    // Heading of the last extraction, from any task. False if it had none
+    bool getWallHeading(WallHeading& wall) const { return published.read(wall) && wall.valid; }
+    bool getFreshWallHeading(WallHeading& wall, uint32_t maxAge, uint32_t now) const { return getWallHeading(wall) && wall.age(now) <= maxAge; }
+
+    void setSplitThreshold(float mm) { splitThreshold = mm; }
+    void setGapThreshold(float mm) { gapThreshold = mm; }
+    void setMinLength(float mm) { minLength = mm; }
+
+    // Sensor velocity for de-skewing (mm/s, rad/s counter-clockwise), zero when unknown
+    void setVelocity(float vx, float vy, float omega) { velocityX = vx; velocityY = vy; angularVelocity = omega; }
+
+private:
+    struct Range {
+        uint16_t first;
+        uint16_t last;
+    };
+
+    int16_t binX[LidarScan::BINS];
+    int16_t binY[LidarScan::BINS];
+    int16_t pointX[LidarScan::BINS];  // Valid returns, in scan order
+    int16_t pointY[LidarScan::BINS];
+    int pointCount = 0;
+
+    Range stack[LidarScan::BINS / 2];
+    Range ranges[MAX_SEGMENTS];
+    LineSegment segments[MAX_SEGMENTS];
+    int segmentCount = 0;
+
+    float heading = 0;
+    bool headingValid = false;
+    Seqlock<WallHeading> published;
+    uint32_t extractions = 0;
+
+    float velocityX = 0;
+    float velocityY = 0;
+    float angularVelocity = 0;
+
+    float splitThreshold = 30.0f;   // mm, max point to chord distance in a segment
+    float gapThreshold = 150.0f;    // mm, larger jumps between points break the wall
+    float mergeAngle = 0.087f;      // rad (5 degrees)
+    float minLength = 300.0f;       // mm
+    float wallLength = 400.0f;      // mm, shortest segment used for the heading
+    int minPoints = 6;
+    uint16_t minValidDist = 60;     // mm
+
+    void split(int first, int last);
+    void fit(const Range& range, LineSegment& segment) const;
+    void merge();
+    void estimateHeading();
+};
+
+#endif
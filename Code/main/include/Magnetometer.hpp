@@ -14,15 +14,53 @@ _\ \   <| |_| / _  \ (_) | (__|   <  __/ |_
 #include <Wire.h>
 #include <Adafruit_Sensor.h>
 #include <Adafruit_LIS2MDL.h>
+#include "EllipseFit.hpp"
+#include "Seqlock.hpp"
 #include "USB.h"
 
+// One sample, published whole by update() so any task reads it without touching I2C
+struct MagReading {
+    float heading;       // Degrees [0, 360), calibrated then low-pass filtered
+    float x;             // Raw field, uT
+    float y;
+    float z;
+    uint32_t timestamp;  // millis() when the sample was read
+    uint32_t sequence;   // Counts samples from 1, 0 = none yet
+
+    uint32_t age(uint32_t now) const { return now - timestamp; }  // ms
+};
+
+struct MagCalibration {
+    float offsetX;       // Hard iron, uT
+    float offsetY;
+    float softIron[4];   // Row-major, applied after the offsets
+};
+
 class Magnetometer {
 private:
     Adafruit_LIS2MDL mag;
-    float magX_offset;
-    float magY_offset;
+    TwoWire* wire = nullptr;
+    Seqlock<MagCalibration> calibration_;  // Written by calibrate(), read by update()
     bool calibrated;
 
+    // Sampling, only update() writes these
+    Seqlock<MagReading> reading_;
+    uint32_t sampleCount = 0;
+    uint32_t calibrationVersion = 0;
+    float filteredX = 0;
+    float filteredY = 0;
+    float filterAlpha = 0.3f;  // Weight of a new sample, ~25 ms time constant at 100 Hz
+
+    static const uint32_t I2C_CLOCK = 400000;  // Fast mode
+    static const uint8_t CFG_REG_C = 0x62;
+    static const uint8_t DRDY_ON_PIN = 0x01;
+
+    EllipseFit fit;
+    float fitResidual = 0;   // Fraction of the field radius
+    float fitCoverage = 0;   // Degrees of turn the fit saw
+    float minCoverage = 180.0f;
+    float maxResidual = 0.05f;
+
     float kp;  
     float ki;     
     float kd;   
@@ -40,10 +78,17 @@ public:
     ~Magnetometer();
 
     void begin(TwoWire& wire = Wire, int sda = 38, int scl = 39);
-    bool initialize();
-    bool calibrate(int timeout = 5000);
-    float getHeading();
-    void readRaw(float& x, float& y, float& z);
+    bool initialize();       // Continuous mode at the 100 Hz maximum rate
+    bool enableDataReady();  // Routes data ready to the INT pin
+    void update();           // Reads one sample over I2C and publishes it, from the sampling task only
+    bool calibrate(int timeout = 5000);  // Returns as soon as the fit converged, false keeps the previous calibration
+    float getFitResidual() const { return fitResidual; }  // RMS radius error of the last calibration, fraction of the field
+    float getFitCoverage() const { return fitCoverage; }  // Degrees of turn the last calibration saw
+    // Latest sample, safe from any task. False if there is none yet or a write kept racing the read
+    bool getReading(MagReading& reading) const { return reading_.read(reading) && reading.sequence != 0; }
+    bool getFreshReading(MagReading& reading, uint32_t maxAge) const { return getReading(reading) && reading.age(millis()) <= maxAge; }
+    bool getHeading(float& heading) const;  // Latest published heading, no I2C. False like getReading(), heading is then left alone
+    void readRaw(float& x, float& y, float& z) const;
 
     void setPIDTunings(float kp, float ki, float kd);
     void setTargetHeading(float target);
@@ -0,0 +1,63 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  OccupancyGrid.hpp    */
+
+#ifndef OCCUPANCYGRID_HPP
+#define OCCUPANCYGRID_HPP
+
+#include <stdint.h>
+#include "LidarFramer.hpp"
+
+// Log-odds occupancy grid of the 3 m x 2 m table, one int8 per cell in row
+// major order. Beams are traced with integer Bresenham: cells crossed get a
+// miss, the end cell gets a hit.
+class OccupancyGrid {
+public:
+    static const int TABLE_WIDTH = 3000;   // mm
+    static const int TABLE_HEIGHT = 2000;  // mm
+    static const int CELL_SIZE = 20;       // mm
+    static const int WIDTH = TABLE_WIDTH / CELL_SIZE;
+    static const int HEIGHT = TABLE_HEIGHT / CELL_SIZE;
+
+    static const int8_t LOG_ODDS_HIT = 12;
+    static const int8_t LOG_ODDS_MISS = -3;
+    static const int8_t LOG_ODDS_MAX = 120;
+    static const int8_t LOG_ODDS_MIN = -120;
+    static const uint16_t MAX_RANGE = 3600;  // mm, longer returns only clear cells
+
+    OccupancyGrid();
+
+    void clear();
+
+    // Sensor pose in table frame: mm, heading in 0.01 degrees counter-clockwise from +x.
+    // LD06 angles are clockwise, so a beam at angle a points along heading - a.
+    void setPose(int32_t x, int32_t y, int32_t heading);
+    void addPacket(const LidarPacket& packet);
+    void addBeam(uint16_t angle, uint16_t distance);
+
+    int8_t getCell(int cx, int cy) const { return cells[cy * WIDTH + cx]; }
+    bool isOccupied(int32_t x, int32_t y) const;  // mm, table frame
+    uint32_t getBeamCount() const { return beams; }
+    const int8_t* getCells() const { return cells; }
+
+private:
+    int8_t cells[WIDTH * HEIGHT];
+    int32_t poseX = 0;
+    int32_t poseY = 0;
+    int32_t poseHeading = 0;
+    uint32_t beams = 0;
+
+    void trace(int x0, int y0, int x1, int y1, bool hit);
+    static void addLogOdds(int8_t& cell, int8_t delta);
+};
+
+static_assert(sizeof(int8_t) * OccupancyGrid::WIDTH * OccupancyGrid::HEIGHT <= 100 * 1024, "Occupancy grid exceeds its 100 KB budget");
+
+#endif
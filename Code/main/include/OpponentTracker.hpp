@@ -0,0 +1,113 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  OpponentTracker.hpp    */
+
+#ifndef OPPONENTTRACKER_HPP
+#define OPPONENTTRACKER_HPP
+
+#include <stdint.h>
+#include "LidarScan.hpp"
+#include "Seqlock.hpp"
+
+// One tracked object in the table frame
+struct OpponentTrack {
+    float x;          // mm
+    float y;          // mm
+    float vx;         // mm/s
+    float vy;         // mm/s
+    float p00;        // Position variance, mm^2 (same for both axes)
+    float p01;        // Position-velocity covariance
+    float p11;        // Velocity variance
+    uint8_t id;
+    uint8_t hits;
+    uint8_t misses;
+    bool confirmed;
+    unsigned long timestamp;  // ms of the last update
+};
+
+// Removes the static arena (table borders) from a LidarScan, clusters the
+// remaining points and follows each cluster with a constant-velocity Kalman
+// filter. x and y share the same model and noise, so a single 2x2 covariance
+// per track serves both axes.
+class OpponentTracker {
+public:
+    static const int MAX_TRACKS = 4;
+    static const int MAX_CLUSTERS = 8;
+
+    OpponentTracker();
+
+    // Sensor pose in table frame (mm, degrees counter-clockwise), now in ms
+    void setPose(float x, float y, float theta);
+    void invalidatePose();  // No pose: nothing is reported until the next setPose()
+    int update(const LidarScan& scan, unsigned long now);  // Returns the number of confirmed tracks
+    void reset();
+
+    // Working copy, only for the task calling update()
+    int getTrackCount() const { return trackCount; }
+    const OpponentTrack& getTrack(int index) const { return tracks[index]; }
+    void predict(int index, float seconds, float& x, float& y) const;
+
+    // Nearest predicted opponent edge (mm) within +-halfWidth degrees of heading
+    // (sensor frame, clockwise like the LD06) over the next horizon seconds.
+    // Tracks not updated for maxTrackAge are ignored. Safe from any task: it
+    // reads the last published snapshot, and returns 0 if that read fails
+    uint16_t nearestInCone(float heading, float halfWidth, float horizon, unsigned long now) const;
+
+    void setBorderMargin(float mm) { borderMargin = mm; }
+    void setOpponentRadius(float mm) { opponentRadius = mm; }
+    void setMaxTrackAge(unsigned long ms) { maxTrackAge = ms; }
+
+private:
+    OpponentTrack tracks[MAX_TRACKS];
+    int trackCount = 0;
+    uint8_t nextId = 0;
+
+    float clusterX[MAX_CLUSTERS];
+    float clusterY[MAX_CLUSTERS];
+    int clusterCount = 0;
+
+    float poseX = 0;
+    float poseY = 0;
+    float poseTheta = 0;
+    bool poseValid = false;
+
+    // Tracks and the pose they were computed from, published whole after each update
+    struct Snapshot {
+        OpponentTrack tracks[MAX_TRACKS];
+        int trackCount;
+        float poseX;      // mm
+        float poseY;      // mm
+        float poseTheta;  // rad
+        bool poseValid;
+    };
+    Seqlock<Snapshot> snapshot;  // What nearestInCone() sees
+
+    float borderMargin = 80.0f;      // mm inside the table edge still counted as wall
+    float clusterGap = 100.0f;       // mm between consecutive points of one object
+    float minClusterWidth = 30.0f;   // mm
+    float maxClusterWidth = 500.0f;  // mm
+    float opponentRadius = 150.0f;   // mm, visible face to robot centre
+    float gate = 400.0f;             // mm, largest cluster to track distance
+    float accelerationNoise = 2000.0f;  // mm/s^2
+    float measurementNoise = 30.0f;     // mm
+    uint16_t minValidDist = 60;
+    uint8_t confirmHits = 3;
+    uint8_t maxMisses = 5;
+    unsigned long maxTrackAge = 500;    // ms without an update before a track is dropped
+
+    void cluster(const LidarScan& scan);
+    void addCluster(float sumX, float sumY, int count, float width);
+    bool project(const LidarScan& scan, int bin, float c, float s, float& x, float& y) const;  // False if dropped
+    bool isArena(float x, float y) const;
+    void removeTrack(int index);
+    void publish();
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  PosePredictor.hpp    */
+
+#ifndef POSEPREDICTOR_HPP
+#define POSEPREDICTOR_HPP
+
+#include <stdint.h>
+
+// Predicts the beacon position at any time from slow, late Hedgehog fixes
+// and the motion the controller commands. The commanded velocity is
+// integrated into a displacement track; each fix, taken latency ms before it
+// was received, is compared with the track at that moment. A line fitted
+// through those residuals over the recent fixes absorbs noise, wheel slip
+// and speed scale errors, and is extrapolated to the requested time.
+//
+// Not thread safe: the task that steers feeds it and reads it.
+class PosePredictor {
+public:
+    static const int MAX_FIXES = 8;
+    static const int MOTION_SAMPLES = 64;
+
+    PosePredictor();
+
+    void addMotion(float vx, float vy, uint32_t now);     // Commanded velocity from now on, mm/s in the beacon frame
+    void addFix(float x, float y, uint32_t received);     // mm, received in ms
+    bool predict(uint32_t now, float& x, float& y) const; // False before the first fix
+    void reset();
+
+    // Velocity the last prediction assumed, mm/s
+    float getVelocityX() const { return velocityX + correctionX; }
+    float getVelocityY() const { return velocityY + correctionY; }
+
+    void setLatency(uint32_t ms) { latency = ms; }        // Measurement to reception
+    void setWindow(uint32_t ms) { window = ms; }          // Fixes older than this are not fitted
+    void setMaxCorrection(float mmPerSecond) { maxCorrection = mmPerSecond; }
+
+private:
+    struct Sample {
+        uint32_t time;
+        float x;  // Integrated commanded displacement, mm
+        float y;
+    };
+
+    Sample motion[MOTION_SAMPLES];  // Ring of displacement samples
+    int motionHead = 0;
+    int motionCount = 0;
+    float velocityX = 0;            // Commanded since the last sample
+    float velocityY = 0;
+
+    Sample residuals[MAX_FIXES];    // Fix minus displacement at the measurement time
+    int fixHead = 0;
+    int fixCount = 0;
+
+    // Line through the residuals, re-fitted on every fix
+    uint32_t fitTime = 0;
+    float offsetX = 0;
+    float offsetY = 0;
+    float correctionX = 0;          // mm/s
+    float correctionY = 0;
+
+    uint32_t latency = 100;
+    uint32_t window = 1000;
+    float maxCorrection = 500.0f;
+
+    void displacement(uint32_t time, float& x, float& y) const;
+    void fit();
+};
+
+#endif
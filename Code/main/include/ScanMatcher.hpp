@@ -0,0 +1,96 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  ScanMatcher.hpp    */
+
+#ifndef SCANMATCHER_HPP
+#define SCANMATCHER_HPP
+
+#include <stdint.h>
+#include "LidarScan.hpp"
+
+// Motion of the sensor between two revolutions: the current scan frame
+// expressed in the previous one (x forward, y left, theta counter-clockwise)
+struct ScanMatch {
+    float x;                  // mm
+    float y;                  // mm
+    float theta;              // rad
+    float covariance[3][3];   // x, y, theta
+    float rms;                // Point-to-line residual, mm
+    uint16_t correspondences;
+    bool valid;
+};
+
+// Point-to-line ICP between consecutive LidarScans. Nearest neighbours come
+// from a fixed-size spatial hash of the reference scan, and the number of
+// iterations is fixed so the cost per revolution is bounded.
+class ScanMatcher {
+public:
+    static const int ITERATIONS = 10;
+    static const int HASH_SIZE = 1024;
+    static const int CELL_SIZE = 100;  // mm, also the largest correspondence distance
+
+    ScanMatcher();
+
+    bool match(const LidarScan& scan);  // Aligns with the previous scan, then keeps this one as reference
+    bool hold(const LidarScan& scan);   // Records a zero increment for a scan known not to have changed
+    void reset();
+
+    const ScanMatch& getMatch() const { return result; }
+
+    // Increments composed since reset(), in the first scan's frame
+    float getOdometryX() const { return odometryX; }
+    float getOdometryY() const { return odometryY; }
+    float getOdometryTheta() const { return odometryTheta; }
+
+    // Sensor velocity from the last increment, used to de-skew the next scan
+    float getVelocityX() const { return velocityX; }          // mm/s
+    float getVelocityY() const { return velocityY; }          // mm/s
+    float getAngularVelocity() const { return angularVelocity; }  // rad/s counter-clockwise
+
+private:
+    int16_t binX[LidarScan::BINS];
+    int16_t binY[LidarScan::BINS];
+
+    // Reference scan with unit normals, only points with a usable normal
+    int16_t refX[LidarScan::BINS];
+    int16_t refY[LidarScan::BINS];
+    float refNormalX[LidarScan::BINS];
+    float refNormalY[LidarScan::BINS];
+    int16_t refNext[LidarScan::BINS];  // Hash bucket chains
+    int16_t buckets[HASH_SIZE];
+    int refCount = 0;
+
+    // Current scan
+    int16_t pointX[LidarScan::BINS];
+    int16_t pointY[LidarScan::BINS];
+    int pointCount = 0;
+
+    ScanMatch result = {};
+    float odometryX = 0;
+    float odometryY = 0;
+    float odometryTheta = 0;
+
+    float velocityX = 0;
+    float velocityY = 0;
+    float angularVelocity = 0;
+    uint16_t lastTimestamp = 0;  // Sensor ms at the end of the reference scan
+
+    float gapThreshold = 100.0f;   // mm between neighbours used for a normal
+    float outlierDistance = 100.0f; // mm, larger point-to-line residuals are ignored
+    int minCorrespondences = 40;
+    uint16_t minValidDist = 60;
+
+    void collect(const LidarScan& scan);
+    void buildReference();
+    int nearest(float x, float y) const;
+    static int hash(int cx, int cy);
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  Seqlock.hpp    */
+
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Single writer, many readers, no mutex. The writer makes the sequence odd
+// while it copies and even again after; a reader retries when it saw an odd
+// or changed sequence around its copy. T must be trivially copyable.
+//
+// Readers give up after a few attempts instead of spinning, because every
+// task shares core 1 and a preempted writer would never finish otherwise.
+template <typename T>
+class Seqlock {
+public:
+    Seqlock() : sequence(0) { memset(&value, 0, sizeof(value)); }
+
+    void write(const T& data) {
+        uint32_t next = sequence.load(std::memory_order_relaxed) + 1;
+        sequence.store(next, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&value, &data, sizeof(T));
+        sequence.store(next + 1, std::memory_order_release);
+    }
+
+    bool read(T& out, int attempts = 4) const {
+        while (attempts-- > 0) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // Write in progress
+            }
+            memcpy(&out, &value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint32_t getVersion() const { return sequence.load(std::memory_order_acquire) >> 1; }  // Completed writes
+
+private:
+    std::atomic<uint32_t> sequence;
+    T value;
+};
+
+#endif
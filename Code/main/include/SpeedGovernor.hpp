@@ -0,0 +1,53 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  SpeedGovernor.hpp    */
+
+#ifndef SPEEDGOVERNOR_HPP
+#define SPEEDGOVERNOR_HPP
+
+#include <stdint.h>
+
+// Scales the commanded translation speed from the free distance along the
+// drive direction so the robot can always stop before the obstacle, using a
+// braking-distance budget and a minimum time to collision.
+class SpeedGovernor {
+public:
+    SpeedGovernor();
+
+    // speed in Mecanum units (0-100), range in mm along the drive direction, now in ms
+    int limit(int speed, uint16_t range, unsigned long now);
+    void reset();
+
+    float getTimeToCollision() const { return timeToCollision; }  // Seconds at the commanded speed
+    float getScale() const { return scale; }                      // Last output / command ratio
+
+    void setMaxSpeed(float mmPerSecond) { maxSpeed = mmPerSecond; }       // Speed at command 100
+    float getMaxSpeed() const { return maxSpeed; }
+    void setDeceleration(float mmPerSecond2) { deceleration = mmPerSecond2; }
+    void setAcceleration(float mmPerSecond2) { acceleration = mmPerSecond2; }
+    void setStopDistance(float mm) { stopDistance = mm; }                 // Lidar to bumper plus margin
+    void setReactionTime(float seconds) { reactionTime = seconds; }       // Sensor and loop latency
+    void setMinTimeToCollision(float seconds) { minTimeToCollision = seconds; }
+
+private:
+    float maxSpeed = 1000.0f;          // mm/s
+    float deceleration = 1500.0f;      // mm/s^2
+    float acceleration = 1500.0f;      // mm/s^2, recovery after braking
+    float stopDistance = 200.0f;       // mm
+    float reactionTime = 0.12f;        // s
+    float minTimeToCollision = 0.4f;   // s
+
+    float allowed;                     // Ramped speed limit, mm/s
+    float timeToCollision = 0;
+    float scale = 1;
+    unsigned long lastTime = 0;
+};
+
+#endif
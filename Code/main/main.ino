@@ -18,13 +18,56 @@ _\ \   <| |_| / _  \ (_) | (__|   <  __/ |_
 #include "include/LED.hpp"
 #include "include/BLE.hpp"
 #include "include/Magnetometer.hpp"
-#include "include/lidar.hpp"
+#include "include/Lidar.hpp"
 #include "include/Hedgehog.hpp"
+#include "include/SpeedGovernor.hpp"
+#include "include/OccupancyGrid.hpp"
+#include "include/LineExtractor.hpp"
+#include "include/BeaconPosts.hpp"
+#include "include/ScanMatcher.hpp"
+#include "include/OpponentTracker.hpp"
+#include "include/LidarMerger.hpp"
+#include "include/LidarSummary.hpp"
+#include "include/LidarChange.hpp"
+#include "include/PosePredictor.hpp"
+#include "include/BeaconAlignment.hpp"
 #include "USB.h"
 
 #define DEBUG false
 #define DEBUG_PRINTLN(x) if (DEBUG) USBSerial.println(x)
 
+#define CONE_HALF_WIDTH 30.0f       // Degrees each side of the drive direction
+#define CONE_TURN_WIDENING 0.3f     // Extra degrees per unit of turn
+
+#define USE_WALL_HEADING true       // Yaw compensation follows the table walls when the lidar sees them
+#define WALL_HEADING_TIMEOUT 300    // ms before falling back to the magnetometer
+#define USE_BEACON_HEADING true     // Without walls, yaw compensation follows the Marvelmind fused IMU
+#define BEACON_HEADING_TIMEOUT 200  // ms before the fused IMU heading is too old
+#define POSTS_POSE_TIMEOUT 300      // ms a beacon post fix is preferred over the Hedgehog
+#define BEACON_TABLE_X 0.0f         // mm, Marvelmind origin in the table frame
+#define BEACON_TABLE_Y 0.0f
+#define BEACON_TABLE_ANGLE 0.0f     // Degrees counter-clockwise from table +x to beacon +x
+#define START_TEAM BeaconPosts::BLUE // Side the beacon posts are placed for until a TEAM command
+#define HEDGEHOG_FIX_TIMEOUT 500    // ms before a Hedgehog fix is too old to steer on
+#define HEDGEHOG_LATENCY 100        // ms from a Marvelmind measurement to its datagram
+#define MIN_FIX_QUALITY 20          // Filtered fixes below this do not correct the GOTO prediction
+#define GOTO_PERIOD 20              // ms between GOTO control updates on predicted poses
+#define BEACON_CALIBRATION_SPEED 40 // Straight drive while the beacon frame is fitted
+#define BEACON_CALIBRATION_TIME 800 // ms of driving, fixes keep coming for HEDGEHOG_LATENCY after
+#define OPPONENT_HORIZON 0.5f       // Seconds ahead the governor looks at predicted opponents
+#define STATIC_REFRESH_SCANS 10     // Scans of an unchanged scene before a full pass anyway
+#define STATIC_POSE_TIMEOUT 1200    // ms walls and posts may age while the scene stays unchanged
+#define LIDAR_DEGRADED_SPEED 30     // Speed cap while the lidar link is unhealthy, stalled stops
+#define HEALTH_REPORT_INTERVAL 1000 // ms between lidar health notifications
+#define MAG_DRDY_PIN -1             // LIS2MDL INT pin wakes the magnetometer task on data ready, -1 = timed
+#define MAG_PERIOD 10               // ms, the 100 Hz continuous rate, also the data ready fallback
+
+#define SECOND_LIDAR false          // Second LD06 on UART2, merged into one robot-frame scan
+#define LIDAR2_RX_PIN 16
+#define LIDAR2_MOUNT_X -120.0f      // mm from the first lidar, x forward
+#define LIDAR2_MOUNT_Y 0.0f         // mm, y left
+#define LIDAR2_MOUNT_ANGLE 180.0f   // Degrees clockwise of its 0 direction from robot forward
+
 USBCDC USBSerial;
 Mecanum mecanum;
 Emergency emergency;
@@ -34,6 +77,24 @@ BLE ble;
 Magnetometer mag;
 HardwareSerial SerialLidar(1);
 Lidar lidar(SerialLidar, 18);
+#if SECOND_LIDAR
+HardwareSerial SerialLidar2(2);
+Lidar lidar2(SerialLidar2, LIDAR2_RX_PIN);
+LidarMerger merger;
+#endif
+SpeedGovernor governor;
+OccupancyGrid grid;
+LineExtractor walls;
+BeaconPosts posts;
+ScanMatcher odometry;
+unsigned long odometryTimestamp = 0;
+volatile uint8_t team = START_TEAM;  // Set by the TEAM command, scanTask moves the posts between detections
+volatile bool sceneStatic = false;  // Last scan matched the previous one, walls and posts were not re-run
+OpponentTracker opponents;
+LidarSummary summary;
+LidarChange change;
+PosePredictor predictor;  // Owned by goToTask
+BeaconAlignment alignment;  // Owned by calibrateBeaconTask
 
 TaskHandle_t blinkTaskHandle; 
 TaskHandle_t calibrateMagTaskHandle;
@@ -41,6 +102,9 @@ TaskHandle_t calibrateBeaconTaskHandle;
 TaskHandle_t yawCompensatedTaskHandle;
 TaskHandle_t goToTaskHandle;
 TaskHandle_t moveTaskHandle;
+TaskHandle_t lidarTaskHandle;
+TaskHandle_t scanTaskHandle;
+TaskHandle_t magTaskHandle;
 
 enum COMMAND : uint8_t {
     BRIGHTNESS = 0,       // 1 byte: brightness (0-100)
@@ -57,6 +121,7 @@ enum COMMAND : uint8_t {
     CALIBRATE_BEACON, // 0 bytes
     GOTO, // 4 bytes: x, y (16 bit int each)
     BEACON_PID, // 6 bytes: kp, ki, kd (int16_t each)
+    TEAM, // 1 byte: 0 blue, 1 yellow
 };
 
 void emergencyStop(){
@@ -224,6 +289,12 @@ void processCommand(const uint8_t* data, size_t length) {
                 hedgehog.setPIDTunings(kp / 1000.0, ki / 1000.0, kd / 1000.0);
             }
             break;
+
+        case TEAM:
+            if (length >= 2 && data[1] <= BeaconPosts::YELLOW) {
+                team = data[1];
+            }
+            break;
             
         default:
             DEBUG_PRINTLN("Unknown command: " + String(cmd));
@@ -250,9 +321,9 @@ void calibrateMagTask(void *pvParameters) {
     DEBUG_PRINTLN("Calibrating Magnetometer...");
     mecanum.setTurn(-50);
     if (mag.calibrate()) {
-        DEBUG_PRINTLN("Calibration successful.");
+        DEBUG_PRINTLN("Calibration successful. Residual: " + String(mag.getFitResidual() * 100.0f) + " %, Coverage: " + String(mag.getFitCoverage()));
     } else {
-        DEBUG_PRINTLN("Calibration failed.");
+        DEBUG_PRINTLN("Calibration failed. Residual: " + String(mag.getFitResidual() * 100.0f) + " %, Coverage: " + String(mag.getFitCoverage()));
     }
     mecanum.setTurn(0);
     calibrateMagTaskHandle = NULL;
@@ -260,8 +331,49 @@ void calibrateMagTask(void *pvParameters) {
 }
 
 void yawCompensatedTask(void *pvParameters) {
+    float heading = 0;
+    mag.getHeading(heading);
+    float tableOffset = 0;
+    bool tableAligned = false;
+    float beaconOffset = 0;
+    bool beaconAligned = false;
     while (true) {
-        float heading = mag.getHeading();
+        HedgehogImu imu;
+        WallHeading wall;
+        unsigned long wallsTimeout = sceneStatic ? STATIC_POSE_TIMEOUT : WALL_HEADING_TIMEOUT;
+        if (USE_WALL_HEADING && walls.getFreshWallHeading(wall, wallsTimeout, millis())) {
+            // Walls only give the heading modulo 90 degrees: anchor it to the
+            // magnetometer once, then follow it from the previous heading
+            if (!tableAligned) {
+                float magHeading;
+                if (!mag.getHeading(magHeading)) {
+                    vTaskDelay(50);
+                    continue;
+                }
+                tableOffset = magHeading - wall.resolve(magHeading);
+                tableAligned = true;
+                heading = magHeading;
+            }
+            heading = wall.resolve(heading - tableOffset) + tableOffset;
+            heading = fmod(heading + 360.0, 360.0);
+        } else if (USE_BEACON_HEADING && hedgehog.getFreshImu(imu, BEACON_HEADING_TIMEOUT)) {
+            // The beacon yaw turns counter-clockwise from its own axis: anchor
+            // it to the magnetometer once
+            if (!beaconAligned) {
+                float magHeading;
+                if (!mag.getHeading(magHeading)) {
+                    vTaskDelay(50);
+                    continue;
+                }
+                beaconOffset = magHeading + imu.yaw;
+                beaconAligned = true;
+            }
+            heading = fmod(beaconOffset - imu.yaw + 720.0, 360.0);
+        } else if (!mag.getHeading(heading)) {
+            // No heading this cycle: keep the last correction rather than steer towards 0
+            vTaskDelay(50);
+            continue;
+        }
         float turn = mag.computePID(heading);
         mag.setCorrection(turn);
         vTaskDelay(50);
@@ -269,52 +381,272 @@ void yawCompensatedTask(void *pvParameters) {
     vTaskDelete(NULL);
 }
 
+void IRAM_ATTR onMagDataReady() {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(magTaskHandle, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void magTask(void *pvParameters) {
+    // The only task on the magnetometer bus: everyone else reads the published heading
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, MAG_PERIOD);  // Data ready, or the period when it is not wired
+        mag.update();
+    }
+    vTaskDelete(NULL);
+}
+
 void calibrateBeaconTask(void *pvParameters) {
     DEBUG_PRINTLN("Calibrating Beacon...");
-    float heading = mag.getHeading();
-    float x1 = hedgehog.getX();
-    float y1 = hedgehog.getY();
-    DEBUG_PRINTLN("Initial position: X: " + String(x1) + ", Y: " + String(y1) + ", Heading: " + String(heading));
-    mecanum.setSpeed(20);
+    HedgehogFix fix;
+    if (!hedgehog.getRawFix(fix) || fix.age(millis()) > HEDGEHOG_FIX_TIMEOUT) {
+        DEBUG_PRINTLN("Beacon calibration aborted: no recent fix");
+        calibrateBeaconTaskHandle = NULL;
+        vTaskDelete(NULL);
+    }
+
+    // Every raw fix of a short straight drive goes into the fit, the alignment
+    // does its own outlier rejection
+    alignment.reset();
+    float magHeading;
+    if (mag.getHeading(magHeading)) {
+        alignment.addSample(fix.x, fix.y, magHeading);
+    }
+    uint32_t lastFix = fix.sequence;
+    mecanum.setAngle(0);
+    mecanum.setSpeed(BEACON_CALIBRATION_SPEED);
     mecanum.setState(1);
-    vTaskDelay(3000);
-    float x2 = hedgehog.getX();
-    float y2 = hedgehog.getY();
-    DEBUG_PRINTLN("Final position: X: " + String(x2) + ", Y: " + String(y2) + ", Heading: " + String(mag.getHeading()));
-    mecanum.setSpeed(50);
-    mecanum.setState(0);
-    float distance = sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
-    float angle = atan2(y2 - y1, x2 - x1) * 180 / PI;
-    if (angle < 0) {
-        angle += 360;
+    uint32_t start = millis();
+    bool driving = true;
+    while (millis() - start < BEACON_CALIBRATION_TIME + HEDGEHOG_LATENCY) {
+        if (driving && millis() - start >= BEACON_CALIBRATION_TIME) {
+            mecanum.setSpeed(50);
+            mecanum.setState(0);
+            driving = false;
+        }
+        if (hedgehog.getRawFix(fix) && fix.sequence != lastFix) {
+            lastFix = fix.sequence;
+            if (mag.getHeading(magHeading)) {
+                alignment.addSample(fix.x, fix.y, magHeading);
+            }
+        }
+        vTaskDelay(10);
     }
-    hedgehog.setAngle(angle);
-    DEBUG_PRINTLN("Beacon calibration complete. Distance: " + String(distance) + ", Angle: " + String(angle)+ ", Heading: " + String(mag.getHeading()));
+
+    BeaconAlignmentResult result;
+    if (!alignment.solve(result)) {
+        DEBUG_PRINTLN("Beacon calibration failed: " + String(result.inliers) + "/" + String(result.samples) + " fixes kept, angle unchanged");
+        calibrateBeaconTaskHandle = NULL;
+        vTaskDelete(NULL);
+    }
+    hedgehog.setAngle(result.angle, result.heading);
+    DEBUG_PRINTLN("Beacon calibration complete. Angle: " + String(result.angle) + ", Heading: " + String(result.heading) + ", Distance: " + String(result.distance) + ", Residual: " + String(result.residual) + " mm, Heading spread: " + String(result.headingSpread) + ", Fixes: " + String(result.inliers) + "/" + String(result.samples));
     calibrateBeaconTaskHandle = NULL;
     vTaskDelete(NULL);
 }
 
 void moveTask(void *pvParameters) {
     while (true) {
-        mecanum.move(mecanum.getAngle(), mecanum.getSpeed() * mecanum.getState(), mecanum.getTurn() + mag.getCorrection());
+        int speed = mecanum.getSpeed() * mecanum.getState();
+        float coneHalfWidth = CONE_HALF_WIDTH + abs(mecanum.getTurn()) * CONE_TURN_WIDENING;
+        uint16_t range = lidar.nearestInCone(mecanum.getAngle(), coneHalfWidth);
+#if SECOND_LIDAR
+        range = min(range, lidar2.nearestInCone(mecanum.getAngle(), coneHalfWidth));
+#endif
+        range = min(range, opponents.nearestInCone(mecanum.getAngle(), coneHalfWidth, OPPONENT_HORIZON, millis()));
+        // The sectors go stale when the lidar stops, slow down while it is unreliable
+        bool stalled = lidar.getHealth().isStalled();
+        bool degraded = lidar.isDegraded();
+#if SECOND_LIDAR
+        stalled = stalled || lidar2.getHealth().isStalled();
+        degraded = degraded || lidar2.isDegraded();
+#endif
+        if (stalled) {
+            range = 0;
+        } else if (degraded) {
+            speed = constrain(speed, -LIDAR_DEGRADED_SPEED, LIDAR_DEGRADED_SPEED);
+        }
+        speed = governor.limit(speed, range, millis());
+        mecanum.move(mecanum.getAngle(), speed, mecanum.getTurn() + mag.getCorrection());
+        vTaskDelay(5);
+    }
+    vTaskDelete(NULL);
+}
+
+// Robot forward in the beacon frame, degrees counter-clockwise. The calibrated
+// angle holds for the heading it was measured at: the robot turning clockwise
+// since then turns its forward the other way in the beacon frame. False
+// without a magnetometer heading to correct it with
+bool getBeaconHeading(float& heading) {
+    float angle = hedgehog.getAngle();
+    if (hedgehog.isAligned()) {
+        float magHeading;
+        if (!mag.getHeading(magHeading)) {
+            return false;
+        }
+        angle -= fmod(magHeading - hedgehog.getAngleHeading() + 540.0, 360.0) - 180.0;
+    }
+    heading = fmod(angle + 360.0, 360.0);
+    return true;
+}
+
+// Lidar pose on the table: beacon posts when fresh, Hedgehog otherwise. Posts
+// are solved in the table frame, Hedgehog fixes are moved there from the
+// Marvelmind map frame with BEACON_TABLE_X/Y/ANGLE
+bool getLidarPose(float& x, float& y, float& theta) {
+    unsigned long postsTimeout = sceneStatic ? STATIC_POSE_TIMEOUT : POSTS_POSE_TIMEOUT;
+    BeaconPose pose;
+    if (posts.getFreshPose(pose, postsTimeout, millis())) {
+        x = pose.x;
+        y = pose.y;
+        theta = pose.theta;
+        return true;
+    }
+    HedgehogFix fix;
+    float heading;
+    if (!hedgehog.getFreshFix(fix, HEDGEHOG_FIX_TIMEOUT) || !getBeaconHeading(heading)) {
+        return false;
+    }
+    float c = cos(BEACON_TABLE_ANGLE * PI / 180);
+    float s = sin(BEACON_TABLE_ANGLE * PI / 180);
+    x = BEACON_TABLE_X + c * fix.x - s * fix.y;
+    y = BEACON_TABLE_Y + s * fix.x + c * fix.y;
+    theta = fmod(heading + BEACON_TABLE_ANGLE + 360.0, 360.0);
+    return true;
+}
+
+void onLidarPacket(const LidarPacket& packet, void* context) {
+    float x, y, theta;
+    if (!getLidarPose(x, y, theta)) {
+        return;
+    }
+    grid.setPose(x, y, theta * 100);
+    grid.addPacket(packet);
+}
+
+void lidarTask(void *pvParameters) {
+    unsigned long lastHealthReport = 0;
+    while (true) {
+        lidar.update();
+#if SECOND_LIDAR
+        lidar2.update();
+#endif
+        if (millis() - lastHealthReport >= HEALTH_REPORT_INTERVAL) {
+            lastHealthReport = millis();
+            const LidarHealthReport& health = lidar.getHealth().getReport();
+            if (ble.isConnected()) {
+                uint8_t report[LidarHealth::REPORT_SIZE];
+                lidar.getHealth().encode(report);
+                ble.notify(report, sizeof(report));
+            }
+            DEBUG_PRINTLN("Lidar: " + String(health.speed) + " deg/s, " + String(health.packetRate) + " pkt/s, " + String(health.crcErrorRate) + " crc/s, gap " + String(health.largestGap) + ", flags " + String(health.flags));
+        }
         vTaskDelay(5);
     }
     vTaskDelete(NULL);
 }
 
+void scanTask(void *pvParameters) {
+    uint32_t lastSequence = lidar.getScanSequence();
+    uint8_t staticScans = 0;
+    while (true) {
+        uint32_t sequence = lidar.getScanSequence();
+        if (sequence != lastSequence) {
+            lastSequence = sequence;
+            if (posts.getTeam() != team) {
+                posts.setTeam(static_cast<BeaconPosts::Team>(team));
+            }
+#if SECOND_LIDAR
+            // The first lidar paces the merge, the robot frame is its frame
+            const LidarScan* sources[2] = {&lidar.getScan(), &lidar2.getScan()};
+            unsigned long ends[2] = {lidar.getScanTime(), lidar2.getScanTime()};
+            merger.merge(sources, ends, 2);
+            const LidarScan& scan = merger.getScan();
+#else
+            const LidarScan& scan = lidar.getScan();
+#endif
+            // A static scene keeps the last odometry, walls and posts, with a full pass now and then.
+            // Their timestamps stay those of the last extraction: readers allow
+            // STATIC_POSE_TIMEOUT instead while the scene is unchanged
+            change.update(scan);
+            if (change.anyChanged() || ++staticScans >= STATIC_REFRESH_SCANS) {
+                staticScans = 0;
+                sceneStatic = false;
+                if (odometry.match(scan)) {
+                    odometryTimestamp = millis();
+                }
+                walls.setVelocity(odometry.getVelocityX(), odometry.getVelocityY(), odometry.getAngularVelocity());
+                walls.extract(scan, millis());
+                posts.detect(scan, millis());
+            } else {
+                if (odometry.hold(scan)) {
+                    odometryTimestamp = millis();
+                }
+                sceneStatic = true;
+            }
+            float x, y, theta;
+            if (getLidarPose(x, y, theta)) {
+                opponents.setPose(x, y, theta);
+                opponents.update(scan, millis());
+            } else {
+                opponents.invalidatePose();
+            }
+            if (ble.isConnected() && summary.encode(scan, millis())) {
+                for (int i = 0; i < summary.getChunkCount(); i++) {
+                    ble.notify(summary.getChunk(i), LidarSummary::CHUNK_SIZE);
+                }
+            }
+        }
+        vTaskDelay(10);
+    }
+    vTaskDelete(NULL);
+}
+
 void goToTask(void *pvParameters) {
 
     int targetX = hedgehog.getTargetX();
     int targetY = hedgehog.getTargetY();
-    float distanceToTarget = sqrt(pow(targetX - hedgehog.getX(), 2) + pow(targetY - hedgehog.getY(), 2));
-    float offset = hedgehog.getAngle();
+    float distanceToTarget;
+    float offset;
+    while (!getBeaconHeading(offset)) {
+        vTaskDelay(GOTO_PERIOD);
+    }
     mecanum.setState(1);
 
+    // Steer on poses predicted between fixes from the motion commanded here
+    predictor.reset();
+    uint32_t lastFix = 0;
+
     while (true) {
-        float x = hedgehog.getX();
-        float y = hedgehog.getY();
-        float angleToTarget = atan2(targetY - y, targetX - x) * 180 / PI;
-        angleToTarget = offset - angleToTarget;
+        uint32_t now = millis();
+
+        // Hold still rather than steer on a stale position
+        HedgehogFix fix;
+        if (!hedgehog.getFreshFix(fix, HEDGEHOG_FIX_TIMEOUT)) {
+            mecanum.setSpeed(0);
+            predictor.addMotion(0, 0, now);
+            vTaskDelay(GOTO_PERIOD);
+            continue;
+        }
+        if (fix.sequence != lastFix) {
+            lastFix = fix.sequence;
+            if (fix.quality >= MIN_FIX_QUALITY) {
+                predictor.addFix(fix.x, fix.y, fix.timestamp);
+            }
+        }
+
+        // Nothing to steer on until a fix good enough for the predictor arrives
+        float x, y;
+        if (!predictor.predict(now, x, y)) {
+            mecanum.setSpeed(0);
+            predictor.addMotion(0, 0, now);
+            vTaskDelay(GOTO_PERIOD);
+            continue;
+        }
+        float direction = atan2(targetY - y, targetX - x);
+        float angleToTarget = offset - direction * 180 / PI;
         if (angleToTarget < 0) {
             angleToTarget += 360;
         }
@@ -322,7 +654,11 @@ void goToTask(void *pvParameters) {
         int speed = hedgehog.computePID(distanceToTarget);
         mecanum.setAngle(angleToTarget);
         mecanum.setSpeed(speed);
-        vTaskDelay(50);
+
+        // What moveTask will drive until the next update, after the governor
+        float velocity = speed * governor.getScale() * governor.getMaxSpeed() / 100.0f;
+        predictor.addMotion(velocity * cos(direction), velocity * sin(direction), now);
+        vTaskDelay(GOTO_PERIOD);
     }
     mecanum.setState(0);
     vTaskDelete(NULL);
@@ -339,7 +675,14 @@ void setup(){
     emergency.begin();
     led.init();
     lidar.init();
+    lidar.setPacketListener(onLidarPacket, NULL);
+#if SECOND_LIDAR
+    lidar2.init();
+    lidar2.setMountAngle(LIDAR2_MOUNT_ANGLE);
+    merger.setMount(1, LIDAR2_MOUNT_X, LIDAR2_MOUNT_Y, LIDAR2_MOUNT_ANGLE);
+#endif
     hedgehog.init();
+    predictor.setLatency(HEDGEHOG_LATENCY);
 
 
     //Magnetometer setup
@@ -347,12 +690,21 @@ void setup(){
     mag.initialize();        
     mag.setPIDTunings(1.0, 0.2, 0); // kp, ki, kd
     mag.setTargetHeading(90);
+    xTaskCreatePinnedToCore(magTask, "MagTask", 2048, NULL, 1, &magTaskHandle, 1);
+#if MAG_DRDY_PIN >= 0
+    if (mag.enableDataReady()) {
+        pinMode(MAG_DRDY_PIN, INPUT);
+        attachInterrupt(digitalPinToInterrupt(MAG_DRDY_PIN), onMagDataReady, RISING);
+    }
+#endif
 
     // BLE setup
     ble.init();
     ble.setCommandCallback(processCommand);
 
     xTaskCreatePinnedToCore(moveTask, "MoveTask", 2048, NULL, 1, &moveTaskHandle, 1);
+    xTaskCreatePinnedToCore(lidarTask, "LidarTask", 4096, NULL, 1, &lidarTaskHandle, 1);
+    xTaskCreatePinnedToCore(scanTask, "ScanTask", 4096, NULL, 1, &scanTaskHandle, 1);
 }
 
 void loop(){
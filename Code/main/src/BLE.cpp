@@ -15,6 +15,8 @@ _\ \   <| |_| / _  \ (_) | (__|   <  __/ |_
 BLE::BLE()
     : pServer_(nullptr),
       pCharacteristic_(nullptr),
+      pNotifyCharacteristic_(nullptr),
+      notifyMutex_(xSemaphoreCreateMutex()),
       isConnected_(false),
       commandCallback_(nullptr) {
 }
@@ -24,6 +26,7 @@ BLE::~BLE() {
         pServer_->getAdvertising()->stop();
         delete pServer_;
     }
+    vSemaphoreDelete(notifyMutex_);
 }
 
 void BLE::init() {
@@ -38,6 +41,13 @@ void BLE::init() {
     );
 
     pCharacteristic_->setCallbacks(new MyCharacteristicCallbacks(this));
+
+    // Telemetry to the client, notifications only
+    pNotifyCharacteristic_ = pService->createCharacteristic(
+        "beb5483e-36e1-4688-b7f5-ea07361b26a9",
+        BLECharacteristic::PROPERTY_NOTIFY
+    );
+    pNotifyCharacteristic_->addDescriptor(new BLE2902());
     
     pService->start();
 
@@ -57,6 +67,19 @@ void BLE::setCommandCallback(CommandCallback callback) {
     commandCallback_ = callback;
 }
 
+bool BLE::notify(const uint8_t* data, size_t length) {
+    if (!isConnected_ || !pNotifyCharacteristic_) {
+        return false;
+    }
+    // Several tasks share the characteristic, another one must not replace
+    // the value between setValue() and notify()
+    xSemaphoreTake(notifyMutex_, portMAX_DELAY);
+    pNotifyCharacteristic_->setValue((uint8_t*)data, length);
+    pNotifyCharacteristic_->notify();
+    xSemaphoreGive(notifyMutex_);
+    return true;
+}
+
 void BLE::MyServerCallbacks::onConnect(BLEServer* pServer) {
     ble_->isConnected_ = true;
 }
@@ -0,0 +1,260 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  BeaconAlignment.cpp    */
+
+#include <math.h>
+#include "../include/BeaconAlignment.hpp"
+
+static float wrap180(float degrees) {
+    degrees = fmodf(degrees, 360.0f);
+    if (degrees > 180.0f) {
+        degrees -= 360.0f;
+    } else if (degrees < -180.0f) {
+        degrees += 360.0f;
+    }
+    return degrees;
+}
+
+static float median(float* values, int count) {
+    // Insertion sort, count is at most MAX_SAMPLES
+    for (int i = 1; i < count; i++) {
+        float value = values[i];
+        int j = i - 1;
+        while (j >= 0 && values[j] > value) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = value;
+    }
+    return count % 2 ? values[count / 2] : 0.5f * (values[count / 2 - 1] + values[count / 2]);
+}
+
+BeaconAlignment::BeaconAlignment() {
+    reset();
+}
+
+void BeaconAlignment::reset() {
+    count = 0;
+}
+
+bool BeaconAlignment::addSample(float x, float y, float heading) {
+    if (count >= MAX_SAMPLES) {
+        return false;
+    }
+    Sample& sample = samples[count++];
+    sample.x = x;
+    sample.y = y;
+    sample.heading = heading;
+    sample.inlier = true;
+    return true;
+}
+
+int BeaconAlignment::fit(float& cx, float& cy, float& ux, float& uy) const {
+    int n = 0;
+    cx = 0;
+    cy = 0;
+    for (int i = 0; i < count; i++) {
+        if (samples[i].inlier) {
+            cx += samples[i].x;
+            cy += samples[i].y;
+            n++;
+        }
+    }
+    if (n < 2) {
+        return n;
+    }
+    cx /= n;
+    cy /= n;
+
+    float sxx = 0, syy = 0, sxy = 0;
+    for (int i = 0; i < count; i++) {
+        if (samples[i].inlier) {
+            float dx = samples[i].x - cx;
+            float dy = samples[i].y - cy;
+            sxx += dx * dx;
+            syy += dy * dy;
+            sxy += dx * dy;
+        }
+    }
+    float axis = 0.5f * atan2f(2.0f * sxy, sxx - syy);
+    ux = cosf(axis);
+    uy = sinf(axis);
+
+    // The axis has no sign: point it the way the fixes progressed
+    float trend = 0;
+    int index = 0;
+    for (int i = 0; i < count; i++) {
+        if (samples[i].inlier) {
+            float along = (samples[i].x - cx) * ux + (samples[i].y - cy) * uy;
+            trend += (index - 0.5f * (n - 1)) * along;
+            index++;
+        }
+    }
+    if (trend < 0) {
+        ux = -ux;
+        uy = -uy;
+    }
+    return n;
+}
+
+bool BeaconAlignment::consensus() {
+    float tolerance = 2.0f * minResidual;
+    int bestCount = 0;
+    float bestError = 0;
+    int bestI = -1, bestJ = -1;
+    for (int i = 0; i < count; i++) {
+        if (!samples[i].inlier) {
+            continue;
+        }
+        for (int j = i + 1; j < count; j++) {
+            if (!samples[j].inlier) {
+                continue;
+            }
+            float dx = samples[j].x - samples[i].x;
+            float dy = samples[j].y - samples[i].y;
+            float length = sqrtf(dx * dx + dy * dy);
+            if (length < minResidual) {
+                continue;
+            }
+            int agree = 0;
+            float error = 0;
+            for (int k = 0; k < count; k++) {
+                if (!samples[k].inlier) {
+                    continue;
+                }
+                float distance = fabsf((samples[k].x - samples[i].x) * dy - (samples[k].y - samples[i].y) * dx) / length;
+                if (distance <= tolerance) {
+                    agree++;
+                    error += distance;
+                }
+            }
+            if (agree > bestCount || (agree == bestCount && error < bestError)) {
+                bestCount = agree;
+                bestError = error;
+                bestI = i;
+                bestJ = j;
+            }
+        }
+    }
+    if (bestI < 0) {
+        return false;
+    }
+
+    float dx = samples[bestJ].x - samples[bestI].x;
+    float dy = samples[bestJ].y - samples[bestI].y;
+    float length = sqrtf(dx * dx + dy * dy);
+    for (int k = 0; k < count; k++) {
+        if (samples[k].inlier) {
+            float distance = fabsf((samples[k].x - samples[bestI].x) * dy - (samples[k].y - samples[bestI].y) * dx) / length;
+            samples[k].inlier = distance <= tolerance;
+        }
+    }
+    return true;
+}
+
+bool BeaconAlignment::solve(BeaconAlignmentResult& result) {
+    result.samples = count;
+    result.inliers = 0;
+    if (count < minInliers) {
+        return false;
+    }
+
+    // Circular mean of the headings, then drop the samples taken while turning
+    float sinSum = 0, cosSum = 0;
+    for (int i = 0; i < count; i++) {
+        sinSum += sinf(samples[i].heading * (float)M_PI / 180.0f);
+        cosSum += cosf(samples[i].heading * (float)M_PI / 180.0f);
+    }
+    float heading = atan2f(sinSum, cosSum) * 180.0f / (float)M_PI;
+    for (int i = 0; i < count; i++) {
+        samples[i].inlier = fabsf(wrap180(samples[i].heading - heading)) <= maxTurn;
+    }
+
+    // A single jump drags a least-squares line toward it: start from the line
+    // through two fixes that most others agree with
+    if (!consensus()) {
+        result.inliers = 0;
+        return false;
+    }
+
+    float cx = 0, cy = 0, ux = 1, uy = 0;
+    float residuals[MAX_SAMPLES];
+    int n = 0;
+    for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+        n = fit(cx, cy, ux, uy);
+        if (n < minInliers) {
+            result.inliers = n;
+            return false;
+        }
+
+        // 1.4826 MAD is the standard deviation for Gaussian noise
+        int m = 0;
+        for (int i = 0; i < count; i++) {
+            if (samples[i].inlier) {
+                residuals[m++] = fabsf((samples[i].x - cx) * uy - (samples[i].y - cy) * ux);
+            }
+        }
+        float limit = 3.0f * 1.4826f * median(residuals, m);
+        if (limit < minResidual) {
+            limit = minResidual;
+        }
+
+        bool dropped = false;
+        for (int i = 0; i < count; i++) {
+            float distance = fabsf((samples[i].x - cx) * uy - (samples[i].y - cy) * ux);
+            if (samples[i].inlier && distance > limit) {
+                samples[i].inlier = false;
+                dropped = true;
+            }
+        }
+        if (!dropped) {
+            break;
+        }
+        n = fit(cx, cy, ux, uy);
+        if (n < minInliers) {
+            result.inliers = n;
+            return false;
+        }
+    }
+
+    // Report on the final line
+    float squares = 0, headingSquares = 0;
+    float first = 0, last = 0;
+    sinSum = 0;
+    cosSum = 0;
+    for (int i = 0; i < count; i++) {
+        if (!samples[i].inlier) {
+            continue;
+        }
+        float distance = (samples[i].x - cx) * uy - (samples[i].y - cy) * ux;
+        float along = (samples[i].x - cx) * ux + (samples[i].y - cy) * uy;
+        squares += distance * distance;
+        first = along < first ? along : first;
+        last = along > last ? along : last;
+        sinSum += sinf(samples[i].heading * (float)M_PI / 180.0f);
+        cosSum += cosf(samples[i].heading * (float)M_PI / 180.0f);
+    }
+    heading = atan2f(sinSum, cosSum) * 180.0f / (float)M_PI;
+    for (int i = 0; i < count; i++) {
+        if (samples[i].inlier) {
+            float deviation = wrap180(samples[i].heading - heading);
+            headingSquares += deviation * deviation;
+        }
+    }
+
+    float angle = atan2f(uy, ux) * 180.0f / (float)M_PI;
+    result.angle = angle < 0 ? angle + 360.0f : angle;
+    result.heading = heading < 0 ? heading + 360.0f : heading;
+    result.distance = last - first;
+    result.residual = sqrtf(squares / n);
+    result.headingSpread = sqrtf(headingSquares / n);
+    result.inliers = n;
+    return result.distance >= minDistance;
+}
@@ -0,0 +1,220 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  BeaconPosts.cpp    */
+
+#include <math.h>
+#include "../include/BeaconPosts.hpp"
+#include "../include/LidarGeometry.hpp"
+
+BeaconPosts::BeaconPosts() {
+    setTeam(BLUE);
+}
+
+void BeaconPosts::setTeam(Team team) {
+    this->team = team;
+    poseValid = false;
+
+    // Fixed beacon supports around the CDFR table, mm from the table corner
+    if (team == BLUE) {
+        setPost(0, -94, 50);
+        setPost(1, -94, 1950);
+        setPost(2, 3094, 1000);
+    } else {
+        setPost(0, 3094, 50);
+        setPost(1, 3094, 1950);
+        setPost(2, -94, 1000);
+    }
+    postCount = 3;
+}
+
+void BeaconPosts::setPost(int index, float x, float y) {
+    if (index < 0 || index >= MAX_POSTS) {
+        return;
+    }
+    postX[index] = x;
+    postY[index] = y;
+    if (index >= postCount) {
+        postCount = index + 1;
+    }
+}
+
+bool BeaconPosts::detect(const LidarScan& scan, uint32_t now) {
+    cluster(scan);
+    poseValid = false;
+    if (candidateCount < postCount) {
+        return false;
+    }
+
+    // Depth-first search over post -> candidate assignments, pruned on pairwise distances
+    int assignment[MAX_POSTS];
+    int depth = 0;
+    assignment[0] = -1;
+    BeaconPose best = {};
+    best.residual = maxResidual;
+    bool found = false;
+
+    while (depth >= 0) {
+        assignment[depth]++;
+        if (assignment[depth] >= candidateCount) {
+            depth--;
+            continue;
+        }
+
+        bool consistent = true;
+        for (int j = 0; j < depth && consistent; j++) {
+            int a = assignment[j];
+            int b = assignment[depth];
+            if (a == b) {
+                consistent = false;
+                break;
+            }
+            float measured = hypotf(candidateX[a] - candidateX[b], candidateY[a] - candidateY[b]);
+            float expected = hypotf(postX[j] - postX[depth], postY[j] - postY[depth]);
+            consistent = fabsf(measured - expected) < matchTolerance;
+        }
+        if (!consistent) {
+            continue;
+        }
+
+        if (depth == postCount - 1) {
+            BeaconPose candidate;
+            if (solve(assignment, postCount, candidate) < best.residual) {
+                best = candidate;
+                found = true;
+            }
+        } else {
+            depth++;
+            assignment[depth] = -1;
+        }
+    }
+
+    if (found) {
+        best.sequence = scan.sequence;
+        best.timestamp = now;
+        pose_.write(best);
+        poseValid = true;
+    }
+    return poseValid;
+}
+
+void BeaconPosts::cluster(const LidarScan& scan) {
+    candidateCount = 0;
+
+    // Start on a dim bin so no cluster is cut at 0 degrees
+    int start = 0;
+    while (start < LidarScan::BINS && scan.intensities[start] >= intensityThreshold) {
+        start++;
+    }
+    if (start == LidarScan::BINS) {
+        return;
+    }
+
+    float sumX = 0;
+    float sumY = 0;
+    float firstX = 0;
+    float firstY = 0;
+    float lastX = 0;
+    float lastY = 0;
+    int count = 0;
+
+    for (int n = 1; n <= LidarScan::BINS; n++) {
+        int bin = (start + n) % LidarScan::BINS;
+        bool bright = scan.distances[bin] > 0 && scan.intensities[bin] >= intensityThreshold;
+
+        float x = 0;
+        float y = 0;
+        if (bright) {
+            uint32_t angle = bin * LidarScan::BIN_WIDTH + LidarScan::BIN_WIDTH / 2;
+            x = scan.distances[bin] * LidarGeometry::cosQ15(angle) / (float)LidarGeometry::ONE;
+            y = -scan.distances[bin] * LidarGeometry::sinQ15(angle) / (float)LidarGeometry::ONE;
+            if (count > 0 && hypotf(x - lastX, y - lastY) > maxClusterWidth) {
+                bright = false;  // Range jump: close this cluster, this bin starts the next
+                n--;
+            }
+        }
+
+        if (bright) {
+            if (count == 0) {
+                firstX = x;
+                firstY = y;
+            }
+            sumX += x;
+            sumY += y;
+            lastX = x;
+            lastY = y;
+            count++;
+            continue;
+        }
+
+        if (count >= 2 && hypotf(lastX - firstX, lastY - firstY) <= maxClusterWidth && candidateCount < MAX_CANDIDATES) {
+            // The reflector is the near face of the post, move back to its centre
+            float cx = sumX / count;
+            float cy = sumY / count;
+            float range = hypotf(cx, cy);
+            candidateX[candidateCount] = cx + postRadius * cx / range;
+            candidateY[candidateCount] = cy + postRadius * cy / range;
+            candidateCount++;
+        }
+        sumX = 0;
+        sumY = 0;
+        count = 0;
+    }
+}
+
+float BeaconPosts::solve(const int* assignment, int count, BeaconPose& result) const {
+    // Rigid 2D alignment of sensor-frame candidates onto table-frame posts
+    float meanPX = 0, meanPY = 0, meanQX = 0, meanQY = 0;
+    for (int i = 0; i < count; i++) {
+        meanPX += candidateX[assignment[i]];
+        meanPY += candidateY[assignment[i]];
+        meanQX += postX[i];
+        meanQY += postY[i];
+    }
+    meanPX /= count;
+    meanPY /= count;
+    meanQX /= count;
+    meanQY /= count;
+
+    float dot = 0;
+    float cross = 0;
+    for (int i = 0; i < count; i++) {
+        float px = candidateX[assignment[i]] - meanPX;
+        float py = candidateY[assignment[i]] - meanPY;
+        float qx = postX[i] - meanQX;
+        float qy = postY[i] - meanQY;
+        dot += px * qx + py * qy;
+        cross += px * qy - py * qx;
+    }
+
+    float theta = atan2f(cross, dot);
+    float c = cosf(theta);
+    float s = sinf(theta);
+    float tx = meanQX - (c * meanPX - s * meanPY);
+    float ty = meanQY - (s * meanPX + c * meanPY);
+
+    float error = 0;
+    for (int i = 0; i < count; i++) {
+        float px = candidateX[assignment[i]];
+        float py = candidateY[assignment[i]];
+        float ex = c * px - s * py + tx - postX[i];
+        float ey = s * px + c * py + ty - postY[i];
+        error += ex * ex + ey * ey;
+    }
+
+    result.x = tx;
+    result.y = ty;
+    result.theta = theta * 180.0f / 3.14159265f;
+    if (result.theta < 0) {
+        result.theta += 360.0f;
+    }
+    result.matched = count;
+    result.residual = sqrtf(error / count);
+    return result.residual;
+}
@@ -0,0 +1,142 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  EllipseFit.cpp    */
+
+#include <math.h>
+#include <string.h>
+#include "../include/EllipseFit.hpp"
+
+EllipseFit::EllipseFit() {
+    reset();
+}
+
+void EllipseFit::reset() {
+    memset(normal, 0, sizeof(normal));
+    memset(moments, 0, sizeof(moments));
+    count = 0;
+}
+
+void EllipseFit::add(float x, float y) {
+    double phi[TERMS] = {(double)x * x, (double)x * y, (double)y * y, x, y};
+    for (int i = 0; i < TERMS; i++) {
+        for (int j = i; j < TERMS; j++) {
+            normal[i][j] += phi[i] * phi[j];
+        }
+        moments[i] += phi[i];
+    }
+    count++;
+}
+
+bool EllipseFit::solve() {
+    if (count < TERMS * 2) {
+        return false;
+    }
+
+    // Gaussian elimination with partial pivoting on a copy of the normal equations
+    double a[TERMS][TERMS + 1];
+    for (int i = 0; i < TERMS; i++) {
+        for (int j = 0; j < TERMS; j++) {
+            a[i][j] = i <= j ? normal[i][j] : normal[j][i];
+        }
+        a[i][TERMS] = moments[i];
+    }
+    for (int column = 0; column < TERMS; column++) {
+        int pivot = column;
+        for (int row = column + 1; row < TERMS; row++) {
+            if (fabs(a[row][column]) > fabs(a[pivot][column])) {
+                pivot = row;
+            }
+        }
+        if (fabs(a[pivot][column]) < 1e-12 * fabs(normal[column][column]) || a[pivot][column] == 0) {
+            return false;
+        }
+        if (pivot != column) {
+            for (int j = column; j <= TERMS; j++) {
+                double swap = a[column][j];
+                a[column][j] = a[pivot][j];
+                a[pivot][j] = swap;
+            }
+        }
+        for (int row = column + 1; row < TERMS; row++) {
+            double factor = a[row][column] / a[column][column];
+            for (int j = column; j <= TERMS; j++) {
+                a[row][j] -= factor * a[column][j];
+            }
+        }
+    }
+    double p[TERMS];
+    for (int row = TERMS - 1; row >= 0; row--) {
+        double sum = a[row][TERMS];
+        for (int j = row + 1; j < TERMS; j++) {
+            sum -= a[row][j] * p[j];
+        }
+        p[row] = sum / a[row][row];
+    }
+
+    // Conic matrix M = [A B/2; B/2 C] must be positive definite for an ellipse
+    double m00 = p[0], m01 = 0.5 * p[1], m11 = p[2];
+    double det = m00 * m11 - m01 * m01;
+    if (m00 <= 0 || det <= 0) {
+        return false;
+    }
+    double cx = -0.5 * (m11 * p[3] - m01 * p[4]) / det;
+    double cy = -0.5 * (m00 * p[4] - m01 * p[3]) / det;
+    double k = 1.0 + m00 * cx * cx + 2.0 * m01 * cx * cy + m11 * cy * cy;  // (v - c)^T M (v - c) = k on the ellipse
+    if (k <= 0) {
+        return false;
+    }
+    m00 /= k;
+    m01 /= k;
+    m11 /= k;
+    det /= k * k;
+
+    // Symmetric square root of M maps the ellipse to the unit circle, the
+    // geometric mean of the semi-axes scales it back to the field strength
+    double s = sqrt(det);
+    double t = sqrt(m00 + m11 + 2.0 * s);
+    double r = 1.0 / sqrt(s);
+    matrix[0] = (m00 + s) / t * r;
+    matrix[1] = m01 / t * r;
+    matrix[2] = matrix[1];
+    matrix[3] = (m11 + s) / t * r;
+    centerX = cx;
+    centerY = cy;
+    radius = r;
+
+    // Algebraic residual phi.p - 1 = k (rho^2 - 1), about 2 k (rho - 1)
+    double squares = (double)count;
+    for (int i = 0; i < TERMS; i++) {
+        double row = 0;
+        for (int j = 0; j < TERMS; j++) {
+            row += (i <= j ? normal[i][j] : normal[j][i]) * p[j];
+        }
+        squares += p[i] * row - 2.0 * p[i] * moments[i];
+    }
+    residual = squares > 0 ? sqrt(squares / count) / (2.0 * k) : 0;
+
+    // The mean of the corrected samples is the corrected mean, its length on
+    // the unit circle is sin(a/2)/(a/2) for a uniform arc a
+    double mx = moments[3] / count - cx;
+    double my = moments[4] / count - cy;
+    double ux = (matrix[0] * mx + matrix[1] * my) / r;
+    double uy = (matrix[2] * mx + matrix[3] * my) / r;
+    double length = sqrt(ux * ux + uy * uy);
+    double low = 0, high = 2.0 * M_PI;
+    for (int i = 0; i < 20; i++) {
+        double half = 0.25 * (low + high);
+        if (sin(half) / half > length) {
+            low = 2.0 * half;
+        } else {
+            high = 2.0 * half;
+        }
+    }
+    coverage = 0.5 * (low + high) * 180.0 / M_PI;
+    return true;
+}
@@ -0,0 +1,157 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  FixFilter.cpp    */
+
+#include <math.h>
+#include "../include/FixFilter.hpp"
+
+FixFilter::FixFilter() {
+    reset();
+}
+
+void FixFilter::reset() {
+    head = 0;
+    count = 0;
+    consecutiveRejects = 0;
+}
+
+bool FixFilter::trend(uint32_t time, float& x, float& y, float& vx, float& vy, float& span) const {
+    // Least squares over a few accepted fixes, refitted once with Huber
+    // weights so a fix that slipped through the gate barely pulls the line
+    int n = count < TREND_FIXES ? count : TREND_FIXES;
+    if (n < 3) {
+        return false;
+    }
+    span = (at(0).time - at(n - 1).time) * 0.001f;
+    if (span <= 0) {
+        return false;
+    }
+
+    float weights[TREND_FIXES];
+    for (int age = 0; age < n; age++) {
+        weights[age] = 1.0f;
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        float sumW = 0, sumT = 0, sumTT = 0, sumX = 0, sumY = 0, sumTX = 0, sumTY = 0;
+        for (int age = 0; age < n; age++) {
+            const Sample& sample = at(age);
+            float w = weights[age];
+            float t = -(float)(time - sample.time) * 0.001f;
+            sumW += w;
+            sumT += w * t;
+            sumTT += w * t * t;
+            sumX += w * sample.x;
+            sumY += w * sample.y;
+            sumTX += w * t * sample.x;
+            sumTY += w * t * sample.y;
+        }
+        float det = sumW * sumTT - sumT * sumT;
+        if (det < 1e-6f) {
+            return false;
+        }
+        vx = (sumW * sumTX - sumT * sumX) / det;
+        vy = (sumW * sumTY - sumT * sumY) / det;
+        x = (sumX - vx * sumT) / sumW;
+        y = (sumY - vy * sumT) / sumW;
+
+        for (int age = 0; age < n; age++) {
+            const Sample& sample = at(age);
+            float t = -(float)(time - sample.time) * 0.001f;
+            float residual = hypotf(sample.x - (x + vx * t), sample.y - (y + vy * t));
+            float threshold = 0.5f * noise;  // Huber knee
+            weights[age] = residual > threshold ? threshold / residual : 1.0f;
+        }
+    }
+    return true;
+}
+
+bool FixFilter::add(float x, float y, uint32_t time, uint8_t sourceQuality, float& filteredX, float& filteredY, uint8_t& quality) {
+    if (count > 0 && time - at(0).time > MAX_GAP) {
+        reset();
+    }
+    if (count == 0) {
+        push(x, y, time, filteredX, filteredY);
+        quality = sourceQuality > 0 ? sourceQuality : 50;  // Nothing to compare with yet
+        return true;
+    }
+
+    const Sample& last = at(0);
+    float dt = (time - last.time) * 0.001f;
+    if (dt < 0.01f) {
+        dt = 0.01f;
+    }
+
+    // Distance from where the history says the robot should be, and how far off it may be
+    float vx, vy, span;
+    float predictedX = last.filteredX;
+    float predictedY = last.filteredY;
+    float allowed;
+    if (trend(time, predictedX, predictedY, vx, vy, span)) {
+        // The velocity itself is only known to about noise / span
+        allowed = noise + noise / span * dt + 0.5f * maxAcceleration * dt * dt;
+    } else {
+        allowed = noise + maxSpeed * dt;
+    }
+    float innovation = hypotf(x - predictedX, y - predictedY);
+    float travel = hypotf(x - last.filteredX, y - last.filteredY);
+
+    if (innovation > allowed || travel > noise + maxSpeed * dt) {
+        rejected++;
+        float step = hypotf(x - rejectX, y - rejectY);
+        float rejectDt = (time - rejectTime) * 0.001f;
+        if (consecutiveRejects > 0 && step <= noise + maxSpeed * rejectDt) {
+            consecutiveRejects++;
+        } else {
+            consecutiveRejects = 1;
+        }
+        rejectX = x;
+        rejectY = y;
+        rejectTime = time;
+
+        if (consecutiveRejects < RELOCK_COUNT) {
+            quality = 0;
+            return false;
+        }
+        relocks++;
+        reset();
+        push(x, y, time, filteredX, filteredY);
+        quality = sourceQuality > 0 ? sourceQuality : 50;
+        return true;
+    }
+
+    consecutiveRejects = 0;
+    push(x, y, time, filteredX, filteredY);
+    float score = 100.0f * (1.0f - 0.5f * innovation / allowed);
+    if (sourceQuality > 0) {
+        score *= sourceQuality / 100.0f;
+    }
+    quality = (uint8_t)score;
+    return true;
+}
+
+void FixFilter::push(float x, float y, uint32_t time, float& filteredX, float& filteredY) {
+    Sample& sample = history[head];
+    sample.time = time;
+    sample.x = x;
+    sample.y = y;
+    head = (head + 1) % HISTORY;
+    if (count < HISTORY) {
+        count++;
+    }
+
+    // The fitted line at this fix, the raw fix until there are enough of them
+    float vx, vy, span;
+    if (!trend(time, sample.filteredX, sample.filteredY, vx, vy, span)) {
+        sample.filteredX = x;
+        sample.filteredY = y;
+    }
+    filteredX = sample.filteredX;
+    filteredY = sample.filteredY;
+}
@@ -12,213 +12,160 @@ _\ \   <| |_| / _  \ (_) | (__|   <  __/ |_
 #include <Arduino.h>
 #include "../include/Hedgehog.hpp"
 
+// Little endian fields of a datagram payload
+static int16_t readInt16(const uint8_t* data) {
+    return (int16_t)(data[0] | (data[1] << 8));
+}
+
+static int32_t readInt32(const uint8_t* data) {
+    return (int32_t)((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+}
+
 Hedgehog::Hedgehog(HardwareSerial& serialPort, long baudRate)
     : serial(serialPort),
-      hedgehog_x(0), hedgehog_y(0), hedgehog_z(0),
       imu_acc_x(0), imu_acc_y(0), imu_acc_z(0),
       imu_gyro_x(0), imu_gyro_y(0), imu_gyro_z(0),
-      imu_raw_timestamp(0),
-      hedgehog_serial_buf_ofs(0),
-      hedgehog_data_id(0) {
+      imu_raw_timestamp(0) {
 }
 
 Hedgehog::~Hedgehog() {
 }
 
 bool Hedgehog::init() {
+    serial.setRxBufferSize(RX_BUFFER_SIZE);  // Must be set before begin()
     serial.begin(115200);  // Default baud rate from original code
     serial.println("Init");
-    hedgehog_serial_buf_ofs = 0;
+    framer.reset();
     return true;  // No hardware check, so assume success
 }
 
 void Hedgehog::update() {
-    int incoming_byte;
-    int total_received_in_loop = 0;
-    bool packet_received = false;
-    byte packet_size;
-    uni_8x2_16 un16;
-    uni_8x4_32 un32;
-    uni_8x8_64 un64;
-
-    while (serial.available() > 0) {
-        if (hedgehog_serial_buf_ofs >= HEDGEHOG_BUF_SIZE) {
-            hedgehog_serial_buf_ofs = 0;  // Buffer overflow, reset
+    // Non-blocking reads straight out of the UART driver's ring buffer, a burst
+    // of datagrams is decoded in one call instead of one per loop()
+    int available;
+    while ((available = serial.available()) > 0) {
+        size_t bytesRead = serial.read(rxChunk, min(available, (int)RX_CHUNK_SIZE));
+        if (bytesRead == 0) {
             break;
         }
-        total_received_in_loop++;
-        if (total_received_in_loop > 100) break;  // Limit data without header
-
-        incoming_byte = serial.read();
-        bool good_byte = false;
-
-        switch (hedgehog_serial_buf_ofs) {
-            case 0:
-                good_byte = (incoming_byte == 0xff);
-                break;
-            case 1:
-                good_byte = (incoming_byte == 0x47);
-                break;
-            case 2:
-                good_byte = true;
-                break;
-            case 3:
-                hedgehog_data_id = (((unsigned int)incoming_byte) << 8) + hedgehog_serial_buf[2];
-                good_byte = (hedgehog_data_id == POSITION_DATAGRAM_ID) ||
-                            (hedgehog_data_id == POSITION_DATAGRAM_HIGHRES_ID) ||
-                            (hedgehog_data_id == RAW_IMU_DATAGRAM_ID) ||
-                            (hedgehog_data_id == NT_POSITION_DATAGRAM_HIGHRES_ID) ||
-                            (hedgehog_data_id == NT_RAW_IMU_DATAGRAM_ID);
-                break;
-            case 4:
-                switch (hedgehog_data_id) {
-                    case POSITION_DATAGRAM_ID:
-                        good_byte = (incoming_byte == HEDGEHOG_CM_DATA_SIZE);
-                        break;
-                    case POSITION_DATAGRAM_HIGHRES_ID:
-                        good_byte = (incoming_byte == HEDGEHOG_MM_DATA_SIZE);
-                        break;
-                    case RAW_IMU_DATAGRAM_ID:
-                        good_byte = (incoming_byte == HEDGEHOG_RAW_IMU_DATA_SIZE);
-                        break;
-                    case NT_POSITION_DATAGRAM_HIGHRES_ID:
-                    case NT_RAW_IMU_DATAGRAM_ID:
-                        good_byte = true;
-                        break;
-                }
-                break;
-            default:
-                good_byte = true;
-                break;
-        }
-
-        if (!good_byte) {
-            hedgehog_serial_buf_ofs = 0;  // Reset on bad byte
-            continue;
-        }
-
-        hedgehog_serial_buf[hedgehog_serial_buf_ofs++] = incoming_byte;
-        if (hedgehog_serial_buf_ofs > 5) {
-            packet_size = 7 + hedgehog_serial_buf[4];
-            if (hedgehog_serial_buf_ofs == packet_size) {
-                packet_received = true;
-                hedgehog_serial_buf_ofs = 0;
-                break;
-            }
-        }
+        framer.parse(rxChunk, bytesRead, onDatagram, this);
     }
+}
 
-    if (packet_received) {
-        setCrc16(hedgehog_serial_buf, packet_size);
-        if (hedgehog_serial_buf[packet_size] == 0 && hedgehog_serial_buf[packet_size + 1] == 0) {
-            switch (hedgehog_data_id) {
-                case POSITION_DATAGRAM_ID:
-                    un16.b[0] = hedgehog_serial_buf[9];
-                    un16.b[1] = hedgehog_serial_buf[10];
-                    hedgehog_x = 10 * long(un16.wi);
-
-                    un16.b[0] = hedgehog_serial_buf[11];
-                    un16.b[1] = hedgehog_serial_buf[12];
-                    hedgehog_y = 10 * long(un16.wi);
-
-                    un16.b[0] = hedgehog_serial_buf[13];
-                    un16.b[1] = hedgehog_serial_buf[14];
-                    hedgehog_z = 10 * long(un16.wi);
-
-                    break;
-
-                case POSITION_DATAGRAM_HIGHRES_ID:
-                case NT_POSITION_DATAGRAM_HIGHRES_ID:
-                    {  // Add scope to isolate 'ofs'
-                        byte ofs = (hedgehog_data_id == NT_POSITION_DATAGRAM_HIGHRES_ID) ? 13 : 9;
-
-                        un32.b[0] = hedgehog_serial_buf[ofs + 0];
-                        un32.b[1] = hedgehog_serial_buf[ofs + 1];
-                        un32.b[2] = hedgehog_serial_buf[ofs + 2];
-                        un32.b[3] = hedgehog_serial_buf[ofs + 3];
-                        hedgehog_x = un32.vi32;
-
-                        un32.b[0] = hedgehog_serial_buf[ofs + 4];
-                        un32.b[1] = hedgehog_serial_buf[ofs + 5];
-                        un32.b[2] = hedgehog_serial_buf[ofs + 6];
-                        un32.b[3] = hedgehog_serial_buf[ofs + 7];
-                        hedgehog_y = un32.vi32;
-
-                        un32.b[0] = hedgehog_serial_buf[ofs + 8];
-                        un32.b[1] = hedgehog_serial_buf[ofs + 9];
-                        un32.b[2] = hedgehog_serial_buf[ofs + 10];
-                        un32.b[3] = hedgehog_serial_buf[ofs + 11];
-                        hedgehog_z = un32.vi32;
-                    }
-                    break;
-
-                case RAW_IMU_DATAGRAM_ID:
-                case NT_RAW_IMU_DATAGRAM_ID:
-                    un16.b[0] = hedgehog_serial_buf[5];
-                    un16.b[1] = hedgehog_serial_buf[6];
-                    imu_acc_x = un16.wi;
-
-                    un16.b[0] = hedgehog_serial_buf[7];
-                    un16.b[1] = hedgehog_serial_buf[8];
-                    imu_acc_y = un16.wi;
-
-                    un16.b[0] = hedgehog_serial_buf[9];
-                    un16.b[1] = hedgehog_serial_buf[10];
-                    imu_acc_z = un16.wi;
-
-                    un16.b[0] = hedgehog_serial_buf[11];
-                    un16.b[1] = hedgehog_serial_buf[12];
-                    imu_gyro_x = un16.wi;
-
-                    un16.b[0] = hedgehog_serial_buf[13];
-                    un16.b[1] = hedgehog_serial_buf[14];
-                    imu_gyro_y = un16.wi;
-
-                    un16.b[0] = hedgehog_serial_buf[15];
-                    un16.b[1] = hedgehog_serial_buf[16];
-                    imu_gyro_z = un16.wi;
-
-                    if (hedgehog_data_id == RAW_IMU_DATAGRAM_ID) {
-                        un32.b[0] = hedgehog_serial_buf[29];
-                        un32.b[1] = hedgehog_serial_buf[30];
-                        un32.b[2] = hedgehog_serial_buf[31];
-                        un32.b[3] = hedgehog_serial_buf[32];
-                        imu_raw_timestamp = un32.vi32;
-                    } else {
-                        un64.b[0] = hedgehog_serial_buf[29];
-                        un64.b[1] = hedgehog_serial_buf[30];
-                        un64.b[2] = hedgehog_serial_buf[31];
-                        un64.b[3] = hedgehog_serial_buf[32];
-                        un64.b[4] = hedgehog_serial_buf[33];
-                        un64.b[5] = hedgehog_serial_buf[34];
-                        un64.b[6] = hedgehog_serial_buf[35];
-                        un64.b[7] = hedgehog_serial_buf[36];
-                        imu_raw_timestamp = un64.vi64;
-                    }
-
-                    break;
+// Sizes from the Marvelmind protocol; the NT variants only have a lower bound
+const Hedgehog::DatagramType Hedgehog::DATAGRAM_TYPES[] = {
+    {POSITION_DATAGRAM_ID,            0x10, 0x10, decodePositionCm},
+    {POSITION_DATAGRAM_HIGHRES_ID,    0x16, 0x16, decodePositionMm},
+    {NT_POSITION_DATAGRAM_HIGHRES_ID, 20,   255,  decodePositionMm},
+    {RAW_IMU_DATAGRAM_ID,             0x20, 0x20, decodeRawImu},
+    {NT_RAW_IMU_DATAGRAM_ID,          32,   255,  decodeRawImu},
+    {FUSED_IMU_DATAGRAM_ID,           0x2A, 0x2A, decodeFusedImu},
+    {NT_FUSED_IMU_DATAGRAM_ID,        0x2A, 255,  decodeFusedImu},
+    {TELEMETRY_DATAGRAM_ID,           3,    255,  decodeTelemetry},
+    {QUALITY_DATAGRAM_ID,             2,    255,  decodeQuality},
+};
+
+void Hedgehog::onDatagram(uint16_t id, const uint8_t* payload, uint8_t size, void* context) {
+    Hedgehog* hedgehog = static_cast<Hedgehog*>(context);
+    for (const DatagramType& type : DATAGRAM_TYPES) {
+        if (type.id == id) {
+            if (size >= type.minSize && size <= type.maxSize) {
+                type.decode(*hedgehog, id, payload, size);
+                return;
             }
+            break;
         }
     }
+    hedgehog->rejectedDatagrams++;
 }
 
-void Hedgehog::setCrc16(byte* buf, byte size) {
-    uni_8x2_16 sum;
-    byte shift_cnt;
-    byte byte_cnt;
+void Hedgehog::decodePositionCm(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size) {
+    HedgehogFix fix;
+    fix.x = 10 * int32_t(readInt16(payload + 4));
+    fix.y = 10 * int32_t(readInt16(payload + 6));
+    fix.z = 10 * int32_t(readInt16(payload + 8));
+    hedgehog.publishFix(fix);
+}
 
-    sum.w = 0xffffU;
+void Hedgehog::decodePositionMm(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size) {
+    uint8_t ofs = (id == NT_POSITION_DATAGRAM_HIGHRES_ID) ? 8 : 4;
+    HedgehogFix fix;
+    fix.x = readInt32(payload + ofs);
+    fix.y = readInt32(payload + ofs + 4);
+    fix.z = readInt32(payload + ofs + 8);
+    hedgehog.publishFix(fix);
+}
 
-    for (byte_cnt = size; byte_cnt > 0; byte_cnt--) {
-        sum.w = (unsigned int)((sum.w / 256U) * 256U + ((sum.w % 256U) ^ (buf[size - byte_cnt])));
-        for (shift_cnt = 0; shift_cnt < 8; shift_cnt++) {
-            if ((sum.w & 0x1) == 1) sum.w = (unsigned int)((sum.w >> 1) ^ 0xa001U);
-            else sum.w >>= 1;
-        }
+void Hedgehog::decodeRawImu(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size) {
+    hedgehog.imu_acc_x = readInt16(payload + 0);
+    hedgehog.imu_acc_y = readInt16(payload + 2);
+    hedgehog.imu_acc_z = readInt16(payload + 4);
+    hedgehog.imu_gyro_x = readInt16(payload + 6);
+    hedgehog.imu_gyro_y = readInt16(payload + 8);
+    hedgehog.imu_gyro_z = readInt16(payload + 10);
+
+    if (id == RAW_IMU_DATAGRAM_ID) {
+        hedgehog.imu_raw_timestamp = readInt32(payload + 24);
+    } else {
+        hedgehog.imu_raw_timestamp = (int64_t)((uint32_t)readInt32(payload + 24)) | ((int64_t)readInt32(payload + 28) << 32);
+    }
+}
+
+void Hedgehog::decodeFusedImu(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size) {
+    // Position, then the orientation quaternion scaled by 10000, velocity and acceleration
+    HedgehogFix fix;
+    fix.x = readInt32(payload + 0);
+    fix.y = readInt32(payload + 4);
+    fix.z = readInt32(payload + 8);
+    hedgehog.publishFix(fix);
+
+    HedgehogImu imu;
+    imu.qw = readInt16(payload + 12) / 10000.0f;
+    imu.qx = readInt16(payload + 14) / 10000.0f;
+    imu.qy = readInt16(payload + 16) / 10000.0f;
+    imu.qz = readInt16(payload + 18) / 10000.0f;
+    imu.vx = readInt16(payload + 20);
+    imu.vy = readInt16(payload + 22);
+    imu.vz = readInt16(payload + 24);
+    imu.ax = readInt16(payload + 26);
+    imu.ay = readInt16(payload + 28);
+    imu.az = readInt16(payload + 30);
+
+    float yaw = atan2f(2.0f * (imu.qw * imu.qz + imu.qx * imu.qy), 1.0f - 2.0f * (imu.qy * imu.qy + imu.qz * imu.qz));
+    imu.yaw = yaw * 180.0f / PI;
+    if (imu.yaw < 0) {
+        imu.yaw += 360.0f;
     }
+    imu.timestamp = millis();
+    imu.sequence = ++hedgehog.imuCount;
+    hedgehog.imu_.write(imu);
+}
 
-    buf[size] = sum.b[0];
-    buf[size + 1] = sum.b[1];  // Little endian
+void Hedgehog::decodeTelemetry(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size) {
+    hedgehog.batteryVoltage = (uint16_t)readInt16(payload + 0);
+    hedgehog.rssi = (int8_t)payload[2];
+}
+
+void Hedgehog::decodeQuality(Hedgehog& hedgehog, uint16_t id, const uint8_t* payload, uint8_t size) {
+    hedgehog.qualityAddress = payload[0];
+    hedgehog.quality = payload[1];
+}
+
+void Hedgehog::publishFix(HedgehogFix& fix) {
+    fix.timestamp = millis();
+    fix.sequence = ++rawCount;
+    fix.quality = quality;
+    raw_.write(fix);
+
+    // Multipath jumps stop here, controllers only see fixes that passed the gate
+    float x, y;
+    if (!filter.add(fix.x, fix.y, fix.timestamp, quality, x, y, fix.quality)) {
+        return;
+    }
+    fix.x = lroundf(x);
+    fix.y = lroundf(y);
+    fix.sequence = ++fixCount;
+    fix_.write(fix);
 }
 
 float Hedgehog::computePID(float distanceToTarget){
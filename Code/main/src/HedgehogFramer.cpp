@@ -0,0 +1,202 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  HedgehogFramer.cpp    */
+
+#include <string.h>
+#include "../include/HedgehogFramer.hpp"
+
+// CRC16 Modbus (reflected 0x8005, init 0xFFFF) tables generated at compile
+// time. The robot keeps the single 512 byte table, the host slices by 4 to
+// go through recorded streams faster.
+#if defined(ARDUINO)
+static const int CRC_SLICES = 1;
+#else
+static const int CRC_SLICES = 4;
+#endif
+
+static constexpr uint16_t crcShift(uint16_t crc, int bits) {
+    return bits == 0 ? crc : crcShift((crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1, bits - 1);
+}
+
+static constexpr uint16_t crcEntry(int slice, int byte) {
+    return slice == 0 ? crcShift(byte, 8)
+                      : (crcEntry(slice - 1, byte) >> 8) ^ crcShift(crcEntry(slice - 1, byte) & 0xFF, 8);
+}
+
+template <int... I> struct CrcIndices {};
+template <int N, int... I> struct MakeCrcIndices : MakeCrcIndices<N - 1, N - 1, I...> {};
+template <int... I> struct MakeCrcIndices<0, I...> { typedef CrcIndices<I...> type; };
+
+struct CrcRow {
+    uint16_t entries[256];
+};
+
+struct CrcTable {
+    CrcRow slices[CRC_SLICES];
+};
+
+template <int... I>
+static constexpr CrcRow makeCrcRow(int slice, CrcIndices<I...>) {
+    return CrcRow{{crcEntry(slice, I)...}};
+}
+
+template <int... S>
+static constexpr CrcTable makeCrcTable(CrcIndices<S...>) {
+    return CrcTable{{makeCrcRow(S, MakeCrcIndices<256>::type())...}};
+}
+
+static constexpr CrcTable CRC_TABLE = makeCrcTable(MakeCrcIndices<CRC_SLICES>::type());
+
+static_assert(CRC_TABLE.slices[0].entries[1] == 0xC0C1, "CRC16 Modbus table");
+
+HedgehogFramer::HedgehogFramer()
+    : frameLength(0),
+      hunting(false),
+      datagramCount(0),
+      crcErrors(0),
+      resyncs(0) {
+}
+
+void HedgehogFramer::reset() {
+    frameLength = 0;
+    hunting = false;
+    datagramCount = 0;
+    crcErrors = 0;
+    resyncs = 0;
+}
+
+size_t HedgehogFramer::parse(const uint8_t* data, size_t length, DatagramHandler handler, void* context) {
+    size_t datagrams = 0;
+    size_t i = 0;
+
+    while (i < length) {
+        if (frameLength == 0) {
+            // Hunt for the header byte
+            const uint8_t* header = (const uint8_t*)memchr(data + i, HEADER, length - i);
+            if (header == NULL) {
+                skip();
+                break;
+            }
+            if (header != data + i) {
+                skip();
+                i = header - data;
+            }
+
+            // Fast path: the whole datagram is in the input, hand it over in place
+            if (length - i >= (size_t)HEADER_SIZE) {
+                size_t size = FRAME_OVERHEAD + data[i + 4];
+                if (length - i >= size) {
+                    if (validate(data + i, size)) {
+                        handler(data[i + 2] | (data[i + 3] << 8), data + i + HEADER_SIZE, data[i + 4], context);
+                        datagrams++;
+                        i += size;
+                    } else {
+                        i++;  // Drop this header, resync on the next one
+                    }
+                    continue;
+                }
+            }
+        }
+
+        // Slow path: accumulate a datagram split across calls, first its header then the rest
+        size_t needed = frameLength < HEADER_SIZE ? HEADER_SIZE - frameLength
+                                                  : FRAME_OVERHEAD + frame[4] - frameLength;
+        size_t chunk = (length - i < needed) ? length - i : needed;
+        memcpy(frame + frameLength, data + i, chunk);
+        frameLength += chunk;
+        i += chunk;
+        consume(handler, context, datagrams);
+    }
+
+    return datagrams;
+}
+
+void HedgehogFramer::consume(DatagramHandler handler, void* context, size_t& datagrams) {
+    // A rejected datagram can leave a whole shorter one behind after realigning
+    while (frameLength > 0) {
+        if (frameLength >= 2 && frame[1] != SIGNATURE) {
+            skip();
+            realign(1);
+            continue;
+        }
+        if (frameLength < HEADER_SIZE) {
+            return;
+        }
+        size_t size = FRAME_OVERHEAD + frame[4];
+        if (frameLength < size) {
+            return;
+        }
+        if (!validate(frame, size)) {
+            realign(1);
+            continue;
+        }
+        handler(frame[2] | (frame[3] << 8), frame + HEADER_SIZE, frame[4], context);
+        datagrams++;
+        frameLength -= size;
+        memmove(frame, frame + size, frameLength);
+        if (frameLength > 0 && frame[0] != HEADER) {
+            skip();
+            realign(0);
+        }
+    }
+}
+
+bool HedgehogFramer::validate(const uint8_t* candidate, size_t size) {
+    if (candidate[1] != SIGNATURE) {
+        skip();
+        return false;
+    }
+    if (crc16(candidate, size) != 0) {
+        crcErrors++;
+        skip();
+        return false;
+    }
+    datagramCount++;
+    hunting = false;
+    return true;
+}
+
+void HedgehogFramer::skip() {
+    if (!hunting) {
+        resyncs++;
+        hunting = true;
+    }
+}
+
+void HedgehogFramer::realign(uint16_t from) {
+    // The rejected bytes may still hold the start of the real datagram
+    const uint8_t* end = frame + frameLength;
+    const uint8_t* header = from < frameLength ? (const uint8_t*)memchr(frame + from, HEADER, frameLength - from) : NULL;
+    while (header != NULL && header + 1 < end && header[1] != SIGNATURE) {
+        header = (const uint8_t*)memchr(header + 1, HEADER, end - header - 1);
+    }
+    if (header == NULL) {
+        frameLength = 0;
+        return;
+    }
+    frameLength = end - header;
+    memmove(frame, header, frameLength);
+}
+
+uint16_t HedgehogFramer::crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    size_t i = 0;
+#if !defined(ARDUINO)
+    for (; i + 4 <= length; i += 4) {
+        crc ^= data[i] | (data[i + 1] << 8);
+        crc = CRC_TABLE.slices[3].entries[crc & 0xFF] ^ CRC_TABLE.slices[2].entries[crc >> 8]
+            ^ CRC_TABLE.slices[1].entries[data[i + 2]] ^ CRC_TABLE.slices[0].entries[data[i + 3]];
+    }
+#endif
+    for (; i < length; i++) {
+        crc = (crc >> 8) ^ CRC_TABLE.slices[0].entries[(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
@@ -0,0 +1,59 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarChange.cpp    */
+
+#include <string.h>
+#include "../include/LidarChange.hpp"
+
+LidarChange::LidarChange() {
+    reset();
+}
+
+void LidarChange::reset() {
+    memset(reference, 0, sizeof(reference));
+    memset(mask, 0, sizeof(mask));
+    changedCount = 0;
+    primed = false;
+}
+
+int LidarChange::update(const LidarScan& scan) {
+    memset(mask, 0, sizeof(mask));
+    changedCount = 0;
+
+    for (int sector = 0; sector < SECTORS; sector++) {
+        int first = sector * SECTOR_BINS;
+        int moved = 0;
+        for (int bin = first; bin < first + SECTOR_BINS; bin++) {
+            uint16_t distance = scan.distances[bin];
+            if (distance == 0) {
+                continue;
+            }
+            uint16_t previous = reference[bin];
+            uint16_t difference = distance > previous ? distance - previous : previous - distance;
+            uint16_t relative = (uint32_t)distance * relativeTolerance / 100;
+            if (previous == 0 || difference > (relative > minTolerance ? relative : minTolerance)) {
+                moved++;
+            }
+        }
+
+        if (!primed || moved >= minBins) {
+            mask[sector >> 5] |= 1u << (sector & 31);
+            changedCount++;
+            for (int bin = first; bin < first + SECTOR_BINS; bin++) {
+                if (scan.distances[bin] != 0) {
+                    reference[bin] = scan.distances[bin];
+                }
+            }
+        }
+    }
+
+    primed = true;
+    return changedCount;
+}
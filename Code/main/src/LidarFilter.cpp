@@ -0,0 +1,97 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarFilter.cpp    */
+
+#include <string.h>
+#include "../include/LidarFilter.hpp"
+
+static_assert(LidarFilter::HISTORY == 5, "median5() expects a history of 5 returns");
+
+static inline uint16_t absDiff(uint16_t a, uint16_t b) {
+    return a > b ? a - b : b - a;
+}
+
+LidarFilter::LidarFilter() {
+    reset();
+}
+
+void LidarFilter::reset() {
+    memset(history, 0, sizeof(history));
+    memset(head, 0, sizeof(head));
+    memset(filled, 0, sizeof(filled));
+    memset(confidence, 0, sizeof(confidence));
+    rejected = 0;
+}
+
+bool LidarFilter::addPoint(uint16_t angle, uint16_t distance) {
+    int bin = (angle / LidarScan::BIN_WIDTH) % LidarScan::BINS;
+    if (distance < minValidDist) {
+        return false;  // No return, or the robot itself
+    }
+
+    bool kept;
+    if (filled[bin] < HISTORY) {
+        kept = true;  // Not enough history yet, trust the sensor
+    } else {
+        const uint16_t* h = history[bin];
+        uint16_t median = median5(h[0], h[1], h[2], h[3], h[4]);
+        uint16_t mad = median5(absDiff(h[0], median), absDiff(h[1], median), absDiff(h[2], median),
+                               absDiff(h[3], median), absDiff(h[4], median));
+        kept = absDiff(distance, median) <= tolerance(distance, mad);
+
+        // Spatial support: the same surface in this bin or a neighbour just now
+        for (int offset = -1; offset <= 1 && !kept; offset++) {
+            uint16_t neighbour = latest((bin + offset + LidarScan::BINS) % LidarScan::BINS);
+            kept = neighbour >= minValidDist && absDiff(distance, neighbour) <= tolerance(distance, 0);
+        }
+    }
+
+    history[bin][head[bin]] = distance;
+    head[bin] = (head[bin] + 1) % HISTORY;
+    if (filled[bin] < HISTORY) {
+        filled[bin]++;
+    }
+
+    if (kept) {
+        confidence[bin] += (255 - confidence[bin] + 3) >> 2;
+    } else {
+        confidence[bin] >>= 1;
+        rejected++;
+    }
+    return kept;
+}
+
+uint16_t LidarFilter::latest(int bin) const {
+    if (filled[bin] == 0) {
+        return 0;
+    }
+    return history[bin][(head[bin] + HISTORY - 1) % HISTORY];
+}
+
+uint16_t LidarFilter::tolerance(uint16_t distance, uint16_t spread) const {
+    // 3 MAD is about 2 sigma for Gaussian noise
+    uint32_t relative = (uint32_t)distance * relativeTolerance / 100;
+    uint32_t result = minTolerance > relative ? minTolerance : relative;
+    return result + 3 * spread;
+}
+
+uint16_t LidarFilter::median5(uint16_t a, uint16_t b, uint16_t c, uint16_t d, uint16_t e) {
+    // Sorting network, 7 compare-exchanges down to the middle element
+    uint16_t t;
+    if (a > b) { t = a; a = b; b = t; }
+    if (d > e) { t = d; d = e; e = t; }
+    if (a > c) { t = a; a = c; c = t; }
+    if (b > c) { t = b; b = c; c = t; }
+    if (a > d) { t = a; a = d; d = t; }
+    if (b > e) { t = b; b = e; e = t; }
+    if (c > d) { t = c; c = d; d = t; }
+    if (b > c) { t = b; b = c; c = t; }
+    return c;
+}
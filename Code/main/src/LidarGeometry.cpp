@@ -0,0 +1,61 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarGeometry.cpp    */
+
+#include "../include/LidarGeometry.hpp"
+
+namespace LidarGeometry {
+
+    void polarToCartesian(const uint16_t* angles, const uint16_t* distances, int16_t* x, int16_t* y, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            int32_t p = phase(angles[i]);
+            int32_t d = distances[i];
+            x[i] = (int16_t)((d * sinPhase(p + 0x4000)) >> 15);
+            y[i] = (int16_t)(-((d * sinPhase(p)) >> 15));
+        }
+    }
+
+    void convertPacket(const LidarPacket& packet, int16_t* x, int16_t* y) {
+        uint16_t angles[LidarFramer::POINTS_PER_PACKET];
+        for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+            angles[i] = LidarScanAssembler::pointAngle(packet, i);
+        }
+        polarToCartesian(angles, packet.distances, x, y, LidarFramer::POINTS_PER_PACKET);
+    }
+
+    void convertScan(const LidarScan& scan, int16_t* x, int16_t* y) {
+        for (int bin = 0; bin < LidarScan::BINS; bin++) {
+            int32_t p = phase(bin * LidarScan::BIN_WIDTH + LidarScan::BIN_WIDTH / 2);
+            int32_t d = scan.distances[bin];
+            x[bin] = (int16_t)((d * sinPhase(p + 0x4000)) >> 15);
+            y[bin] = (int16_t)(-((d * sinPhase(p)) >> 15));
+        }
+    }
+
+    void deskewScan(const LidarScan& scan, float vx, float vy, float omega, int16_t* x, int16_t* y) {
+        float duration = scan.duration() / 1000.0f;
+        for (int bin = 0; bin < LidarScan::BINS; bin++) {
+            int32_t p = phase(bin * LidarScan::BIN_WIDTH + LidarScan::BIN_WIDTH / 2);
+            float d = scan.distances[bin] / (float)ONE;
+            float px = d * sinPhase(p + 0x4000);
+            float py = -d * sinPhase(p);
+
+            // Pose at the point's time relative to the end pose, tau <= 0.
+            // Third order sine and cosine: under 0.1% error up to 0.3 rad per scan.
+            float tau = scan.offsets[bin] / 1000.0f - duration;
+            float a = omega * tau;
+            float c = 1.0f - a * a * 0.5f;
+            float s = a - a * a * a * (1.0f / 6.0f);
+            x[bin] = (int16_t)(c * px - s * py + vx * tau);
+            y[bin] = (int16_t)(s * px + c * py + vy * tau);
+        }
+    }
+
+}
@@ -0,0 +1,101 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarMerger.cpp    */
+
+#include <math.h>
+#include <string.h>
+#include "../include/LidarMerger.hpp"
+#include "../include/LidarGeometry.hpp"
+
+static const float MERGE_PI = 3.14159265f;
+
+LidarMerger::LidarMerger() {
+    memset(mounts, 0, sizeof(mounts));
+    memset(&merged, 0, sizeof(merged));
+}
+
+void LidarMerger::setMount(int sensor, float x, float y, float angle) {
+    if (sensor < 0 || sensor >= MAX_SENSORS) {
+        return;
+    }
+    angle = fmodf(angle, 360.0f);
+    if (angle < 0) {
+        angle += 360.0f;
+    }
+    mounts[sensor].x = x;
+    mounts[sensor].y = y;
+    mounts[sensor].angle = angle * 100.0f;
+}
+
+void LidarMerger::merge(const LidarScan* const* scans, const unsigned long* ends, int count) {
+    if (count > MAX_SENSORS) {
+        count = MAX_SENSORS;
+    }
+
+    // Common time base: the earliest source start on the host clock
+    unsigned long start = 0;
+    unsigned long end = 0;
+    for (int s = 0; s < count; s++) {
+        unsigned long sourceStart = ends[s] - scans[s]->duration();
+        if (s == 0 || (long)(sourceStart - start) < 0) {
+            start = sourceStart;
+        }
+        if (s == 0 || (long)(ends[s] - end) > 0) {
+            end = ends[s];
+        }
+    }
+
+    memset(merged.distances, 0, sizeof(merged.distances));
+    memset(merged.intensities, 0, sizeof(merged.intensities));
+    memset(merged.offsets, 0, sizeof(merged.offsets));
+    merged.pointCount = 0;
+    merged.speed = count > 0 ? scans[0]->speed : 0;
+    merged.startTimestamp = start % LidarScan::TIMESTAMP_WRAP;
+    merged.endTimestamp = end % LidarScan::TIMESTAMP_WRAP;
+    merged.sequence++;
+
+    for (int s = 0; s < count; s++) {
+        const LidarScan& scan = *scans[s];
+        const Mount& mount = mounts[s];
+        unsigned long shift = ends[s] - scan.duration() - start;  // Source start after the common start
+
+        for (int bin = 0; bin < LidarScan::BINS; bin++) {
+            uint16_t distance = scan.distances[bin];
+            if (distance == 0) {
+                continue;
+            }
+
+            // Sensor polar to robot Cartesian
+            uint32_t angle = (uint32_t)(bin * LidarScan::BIN_WIDTH + LidarScan::BIN_WIDTH / 2 + mount.angle) % 36000;
+            float x = mount.x + distance * LidarGeometry::cosQ15(angle) / (float)LidarGeometry::ONE;
+            float y = mount.y - distance * LidarGeometry::sinQ15(angle) / (float)LidarGeometry::ONE;
+
+            // Robot Cartesian to robot polar, clockwise
+            float range = sqrtf(x * x + y * y);
+            if (range < 1.0f || range > 0xFFFE) {
+                continue;
+            }
+            float robotAngle = atan2f(-y, x) * 18000.0f / MERGE_PI;
+            if (robotAngle < 0) {
+                robotAngle += 36000.0f;
+            }
+            int target = ((int)robotAngle / LidarScan::BIN_WIDTH) % LidarScan::BINS;
+
+            uint16_t rounded = (uint16_t)(range + 0.5f);
+            if (merged.distances[target] == 0 || rounded < merged.distances[target]) {
+                unsigned long offset = shift + scan.offsets[bin];
+                merged.distances[target] = rounded;
+                merged.intensities[target] = scan.intensities[bin];
+                merged.offsets[target] = offset > 255 ? 255 : offset;
+            }
+            merged.pointCount++;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarScan.cpp    */
+
+#include <string.h>
+#include "../include/LidarScan.hpp"
+
+LidarScanAssembler::LidarScanAssembler() {
+    reset();
+}
+
+void LidarScanAssembler::reset() {
+    memset(buffers, 0, sizeof(buffers));
+    front = 0;
+    back = &buffers[1];
+    lastAngle = 0;
+    started = false;
+}
+
+uint16_t LidarScanAssembler::pointAngle(const LidarPacket& packet, int index) {
+    uint32_t start = packet.startAngle;
+    uint32_t end = packet.endAngle;
+    if (end < start) {
+        end += 36000;  // Packet straddles 0 degrees
+    }
+    uint32_t angle = start + (end - start) * index / (LidarFramer::POINTS_PER_PACKET - 1);
+    return angle % 36000;
+}
+
+void LidarScanAssembler::addPacket(const LidarPacket& packet) {
+    for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+        uint16_t angle = pointAngle(packet, i);
+
+        if (lastAngle > angle + 18000) {
+            // Crossed 0 degrees: the revolution being filled is complete
+            if (started) {
+                back->endTimestamp = packet.timestamp;
+                publish();
+            }
+            started = true;
+            beginRevolution();
+            back->startTimestamp = packet.timestamp;
+        }
+        lastAngle = angle;
+
+        if (!started) {
+            continue;
+        }
+
+        uint16_t distance = packet.distances[i];
+        if (distance == 0) {
+            continue;
+        }
+
+        int bin = angle / LidarScan::BIN_WIDTH;
+        if (back->distances[bin] == 0 || distance < back->distances[bin]) {
+            back->distances[bin] = distance;  // Keep the nearest return per bin
+            back->intensities[bin] = packet.intensities[i];
+            uint16_t offset = LidarScan::elapsed(back->startTimestamp, packet.timestamp);
+            back->offsets[bin] = offset > 255 ? 255 : offset;
+        }
+        back->pointCount++;
+    }
+
+    back->speed = packet.speed;
+    back->endTimestamp = packet.timestamp;
+}
+
+void LidarScanAssembler::beginRevolution() {
+    memset(back->distances, 0, sizeof(back->distances));
+    memset(back->intensities, 0, sizeof(back->intensities));
+    memset(back->offsets, 0, sizeof(back->offsets));
+    back->pointCount = 0;
+}
+
+void LidarScanAssembler::publish() {
+    uint8_t filled = back - buffers;
+    back->sequence = buffers[front].sequence + 1;
+    front = filled;
+    back = &buffers[filled ^ 1];
+}
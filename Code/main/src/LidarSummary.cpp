@@ -0,0 +1,84 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarSummary.cpp    */
+
+#include <string.h>
+#include "../include/LidarSummary.hpp"
+
+LidarSummary::LidarSummary() {
+    memset(chunks, 0, sizeof(chunks));
+}
+
+bool LidarSummary::encode(const LidarScan& scan, unsigned long now) {
+    if (sent && now - lastTime < interval) {
+        return false;
+    }
+    lastTime = now;
+    sent = true;
+    sequence++;
+
+    for (int sector = 0; sector < SECTORS; sector++) {
+        uint16_t nearest = 0xFFFF;
+        for (int bin = sector * SECTOR_BINS; bin < (sector + 1) * SECTOR_BINS; bin++) {
+            uint16_t distance = scan.distances[bin];
+            if (distance != 0 && distance < nearest) {
+                nearest = distance;
+            }
+        }
+
+        uint8_t value = NO_RETURN;
+        if (nearest != 0xFFFF) {
+            uint32_t steps = nearest / RESOLUTION;  // Round down: never reports an obstacle farther than it is
+            value = steps >= NO_RETURN ? NO_RETURN - 1 : (steps == 0 ? 1 : steps);  // 0 reads as no return
+        }
+
+        int chunk = sector / SECTORS_PER_CHUNK;
+        chunks[chunk][CHUNK_HEADER + sector % SECTORS_PER_CHUNK] = value;
+    }
+
+    for (int chunk = 0; chunk < CHUNKS; chunk++) {
+        chunks[chunk][0] = sequence;
+        chunks[chunk][1] = (chunk << 4) | CHUNKS;
+    }
+    return true;
+}
+
+LidarSummaryDecoder::LidarSummaryDecoder()
+    : sequence(0),
+      received(0) {
+    memset(sectors, LidarSummary::NO_RETURN, sizeof(sectors));
+}
+
+bool LidarSummaryDecoder::addChunk(const uint8_t* data, size_t length) {
+    if (length != LidarSummary::CHUNK_SIZE) {
+        return false;
+    }
+    int index = data[1] >> 4;
+    int count = data[1] & 0x0F;
+    if (count != LidarSummary::CHUNKS || index >= count) {
+        return false;
+    }
+
+    if (data[0] != sequence) {
+        sequence = data[0];  // New revolution, a lost chunk keeps its old sectors
+        received = 0;
+    }
+    memcpy(sectors + index * LidarSummary::SECTORS_PER_CHUNK, data + LidarSummary::CHUNK_HEADER, LidarSummary::SECTORS_PER_CHUNK);
+    received |= 1 << index;
+    return received == (1 << count) - 1;
+}
+
+uint16_t LidarSummaryDecoder::getDistance(int sector) const {
+    uint8_t value = sectors[sector];
+    if (value == LidarSummary::NO_RETURN) {
+        return 0;
+    }
+    return value * LidarSummary::RESOLUTION;
+}
@@ -0,0 +1,219 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LineExtractor.cpp    */
+
+#include <math.h>
+#include "../include/LineExtractor.hpp"
+#include "../include/LidarGeometry.hpp"
+
+static const float LINE_PI = 3.14159265f;
+
+LineExtractor::LineExtractor() {
+}
+
+int LineExtractor::extract(const LidarScan& scan, uint32_t now) {
+    LidarGeometry::deskewScan(scan, velocityX, velocityY, angularVelocity, binX, binY);
+
+    pointCount = 0;
+    for (int bin = 0; bin < LidarScan::BINS; bin++) {
+        if (scan.distances[bin] >= minValidDist) {
+            pointX[pointCount] = binX[bin];
+            pointY[pointCount] = binY[bin];
+            pointCount++;
+        }
+    }
+
+    // Break the scan into runs of close points, then split each run
+    segmentCount = 0;
+    float gap2 = gapThreshold * gapThreshold;
+    int first = 0;
+    for (int i = 1; i <= pointCount; i++) {
+        bool end = (i == pointCount);
+        if (!end) {
+            float dx = pointX[i] - pointX[i - 1];
+            float dy = pointY[i] - pointY[i - 1];
+            end = dx * dx + dy * dy > gap2;
+        }
+        if (end) {
+            if (i - first >= minPoints) {
+                split(first, i - 1);
+            }
+            first = i;
+        }
+    }
+
+    merge();
+
+    // Drop short segments
+    int kept = 0;
+    for (int i = 0; i < segmentCount; i++) {
+        if (segments[i].length >= minLength) {
+            segments[kept] = segments[i];
+            ranges[kept] = ranges[i];
+            kept++;
+        }
+    }
+    segmentCount = kept;
+
+    estimateHeading();
+
+    WallHeading wall;
+    wall.heading = heading;
+    wall.valid = headingValid;
+    wall.sequence = ++extractions;
+    wall.timestamp = now;
+    published.write(wall);
+    return segmentCount;
+}
+
+void LineExtractor::split(int first, int last) {
+    int top = 0;
+    stack[top++] = {(uint16_t)first, (uint16_t)last};
+
+    while (top > 0 && segmentCount < MAX_SEGMENTS) {
+        Range range = stack[--top];
+
+        // Farthest point from the chord
+        float ax = pointX[range.first];
+        float ay = pointY[range.first];
+        float dx = pointX[range.last] - ax;
+        float dy = pointY[range.last] - ay;
+        float norm = sqrtf(dx * dx + dy * dy);
+        float worst = 0;
+        int worstIndex = range.first;
+        if (norm > 0) {
+            for (int i = range.first + 1; i < range.last; i++) {
+                float d = fabsf((pointX[i] - ax) * dy - (pointY[i] - ay) * dx) / norm;
+                if (d > worst) {
+                    worst = d;
+                    worstIndex = i;
+                }
+            }
+        }
+
+        if (worst > splitThreshold && top + 2 <= (int)(sizeof(stack) / sizeof(stack[0]))) {
+            // Push the right half first so segments come out in scan order
+            if (range.last - worstIndex + 1 >= minPoints) {
+                stack[top++] = {(uint16_t)worstIndex, range.last};
+            }
+            if (worstIndex - range.first + 1 >= minPoints) {
+                stack[top++] = {range.first, (uint16_t)worstIndex};
+            }
+        } else {
+            ranges[segmentCount] = range;
+            fit(range, segments[segmentCount]);
+            segmentCount++;
+        }
+    }
+}
+
+void LineExtractor::fit(const Range& range, LineSegment& segment) const {
+    int count = range.last - range.first + 1;
+    float meanX = 0;
+    float meanY = 0;
+    for (int i = range.first; i <= range.last; i++) {
+        meanX += pointX[i];
+        meanY += pointY[i];
+    }
+    meanX /= count;
+    meanY /= count;
+
+    float sxx = 0;
+    float syy = 0;
+    float sxy = 0;
+    for (int i = range.first; i <= range.last; i++) {
+        float dx = pointX[i] - meanX;
+        float dy = pointY[i] - meanY;
+        sxx += dx * dx;
+        syy += dy * dy;
+        sxy += dx * dy;
+    }
+
+    // Total least squares direction
+    float angle = 0.5f * atan2f(2.0f * sxy, sxx - syy);
+    float ux = cosf(angle);
+    float uy = sinf(angle);
+
+    // Project the extreme points onto the fitted line
+    float t0 = (pointX[range.first] - meanX) * ux + (pointY[range.first] - meanY) * uy;
+    float t1 = (pointX[range.last] - meanX) * ux + (pointY[range.last] - meanY) * uy;
+
+    segment.startX = meanX + t0 * ux;
+    segment.startY = meanY + t0 * uy;
+    segment.endX = meanX + t1 * ux;
+    segment.endY = meanY + t1 * uy;
+    segment.length = fabsf(t1 - t0);
+    segment.points = count;
+
+    if (angle < 0) {
+        angle += LINE_PI;
+    }
+    segment.angle = angle;
+}
+
+void LineExtractor::merge() {
+    int out = 0;
+    for (int i = 0; i < segmentCount; i++) {
+        if (out > 0) {
+            LineSegment& previous = segments[out - 1];
+            float difference = fabsf(previous.angle - segments[i].angle);
+            if (difference > LINE_PI / 2) {
+                difference = LINE_PI - difference;
+            }
+            bool contiguous = ranges[out - 1].last >= ranges[i].first;
+            if (difference < mergeAngle && contiguous) {
+                ranges[out - 1].last = ranges[i].last;
+                fit(ranges[out - 1], previous);
+                continue;
+            }
+        }
+        ranges[out] = ranges[i];
+        segments[out] = segments[i];
+        out++;
+    }
+    segmentCount = out;
+}
+
+void LineExtractor::estimateHeading() {
+    // Walls are 90 degrees apart: average 4 * angle on the circle
+    float sumSin = 0;
+    float sumCos = 0;
+    float weight = 0;
+    for (int i = 0; i < segmentCount; i++) {
+        if (segments[i].length < wallLength) {
+            continue;
+        }
+        float w = segments[i].length;
+        sumSin += w * sinf(4.0f * segments[i].angle);
+        sumCos += w * cosf(4.0f * segments[i].angle);
+        weight += w;
+    }
+
+    // Require enough wall and agreeing directions
+    headingValid = weight >= 2.0f * wallLength && sqrtf(sumSin * sumSin + sumCos * sumCos) >= 0.8f * weight;
+    if (!headingValid) {
+        return;
+    }
+
+    float angle = atan2f(sumSin, sumCos) / 4.0f * 180.0f / LINE_PI;
+    if (angle < 0) {
+        angle += 90.0f;
+    }
+    heading = angle;
+}
+
+float WallHeading::resolve(float reference) const {
+    float candidate = heading + 90.0f * floorf((reference - heading) / 90.0f + 0.5f);
+    candidate = fmodf(candidate, 360.0f);
+    if (candidate < 0) {
+        candidate += 360.0f;
+    }
+    return candidate;
+}
@@ -13,8 +13,6 @@ _\ \   <| |_| / _  \ (_) | (__|   <  __/ |_
 
 Magnetometer::Magnetometer(int i2cAddress) 
     : mag(i2cAddress), 
-      magX_offset(0),
-      magY_offset(0),
       calibrated(false),
       kp(1.0),         
       ki(0.0),
@@ -23,72 +21,145 @@ Magnetometer::Magnetometer(int i2cAddress)
       lastError(0.0),
       targetHeading(100.0),
       lastTime(0) {
+    MagCalibration identity = {0, 0, {1, 0, 0, 1}};
+    calibration_.write(identity);
 }
 Magnetometer::~Magnetometer() {
 }
 
 void Magnetometer::begin(TwoWire& wire, int sda, int scl) {
     wire.begin(sda, scl);
+    wire.setClock(I2C_CLOCK);
+    this->wire = &wire;
 }
 
 bool Magnetometer::initialize() {
-    if (!mag.begin()) {
+    if (!mag.begin(LIS2MDL_I2CADDR_DEFAULT, wire ? wire : &Wire)) {
         return false;
     }
+    mag.setDataRate(LIS2MDL_RATE_100_HZ);
     return true;
 }
 
+bool Magnetometer::enableDataReady() {
+    TwoWire* bus = wire ? wire : &Wire;
+    bus->beginTransmission(LIS2MDL_I2CADDR_DEFAULT);
+    bus->write(CFG_REG_C);
+    if (bus->endTransmission(false) != 0 || bus->requestFrom((uint8_t)LIS2MDL_I2CADDR_DEFAULT, (uint8_t)1) != 1) {
+        return false;
+    }
+    uint8_t value = bus->read();
+    bus->beginTransmission(LIS2MDL_I2CADDR_DEFAULT);
+    bus->write(CFG_REG_C);
+    bus->write(value | DRDY_ON_PIN);
+    return bus->endTransmission() == 0;
+}
+
+void Magnetometer::update() {
+    sensors_event_t event;
+    if (!mag.getEvent(&event)) {
+        return;
+    }
+
+    MagCalibration calibration;
+    if (!calibration_.read(calibration)) {
+        return;  // calibrate() is writing, the next sample will do
+    }
+    float x = event.magnetic.x - calibration.offsetX;
+    float y = event.magnetic.y - calibration.offsetY;
+    float calibratedX = calibration.softIron[0] * x + calibration.softIron[1] * y;
+    float calibratedY = calibration.softIron[2] * x + calibration.softIron[3] * y;
+
+    // Filter the field vector rather than the angle, so 0/360 needs no care.
+    // A new calibration restarts the filter instead of blending two frames
+    uint32_t version = calibration_.getVersion();
+    if (sampleCount == 0 || version != calibrationVersion) {
+        filteredX = calibratedX;
+        filteredY = calibratedY;
+        calibrationVersion = version;
+    } else {
+        filteredX += filterAlpha * (calibratedX - filteredX);
+        filteredY += filterAlpha * (calibratedY - filteredY);
+    }
+
+    float heading = atan2(filteredY, filteredX);
+    heading = heading * 180.0 / PI;
+    
+    if (heading < 0) {
+        heading += 360.0;
+    }
+
+    MagReading reading;
+    reading.heading = heading;
+    reading.x = event.magnetic.x;
+    reading.y = event.magnetic.y;
+    reading.z = event.magnetic.z;
+    reading.timestamp = millis();
+    reading.sequence = ++sampleCount;
+    reading_.write(reading);
+}
+
 bool Magnetometer::calibrate(int timeout) {
     
-    float magX_min = 1000.0;
-    float magX_max = -1000.0;
-    float magY_min = 1000.0;
-    float magY_max = -1000.0;
+    // Ellipse fit of the horizontal field while turning: the centre is the
+    // hard iron offset, the shape the soft iron distortion of the chassis.
+    // Samples come from the sampling task, each one is used once
+    fit.reset();
+    bool converged = false;
+    uint32_t lastSample = 0;
     
     unsigned long startTime = millis();
     
     while (millis() - startTime < timeout) {
-        sensors_event_t event;
-        mag.getEvent(&event);
+        MagReading reading;
+        if (!getReading(reading) || reading.sequence == lastSample) {
+            vTaskDelay(5);
+            continue;
+        }
+        lastSample = reading.sequence;
+        fit.add(reading.x, reading.y);
         
-        magX_min = min(magX_min, event.magnetic.x);
-        magX_max = max(magX_max, event.magnetic.x);
-        magY_min = min(magY_min, event.magnetic.y);
-        magY_max = max(magY_max, event.magnetic.y);
+        if (fit.getCount() % 10 == 0 && fit.solve() && fit.getCoverage() >= minCoverage && fit.getResidual() <= maxResidual) {
+            converged = true;
+            break;
+        }
         
-        vTaskDelay(50);
+        vTaskDelay(5);
+    }
+    
+    fitResidual = fit.getResidual();
+    fitCoverage = fit.getCoverage();
+    if (!converged) {
+        return false;
     }
     
-    magX_offset = (magX_max + magX_min) / 2.0;
-    magY_offset = (magY_max + magY_min) / 2.0;
+    MagCalibration calibration;
+    calibration.offsetX = fit.getCenterX();
+    calibration.offsetY = fit.getCenterY();
+    memcpy(calibration.softIron, fit.getMatrix(), sizeof(calibration.softIron));
+    calibration_.write(calibration);
         
     calibrated = true;
     return calibrated;
 }
 
-float Magnetometer::getHeading() {
-    sensors_event_t event;
-    mag.getEvent(&event);
-    
-    float calibratedX = event.magnetic.x - magX_offset;
-    float calibratedY = event.magnetic.y - magY_offset;
-    
-    float heading = atan2(calibratedY, calibratedX);
-    heading = heading * 180.0 / PI;
-    
-    if (heading < 0) {
-        heading += 360.0;
+bool Magnetometer::getHeading(float& heading) const {
+    MagReading reading;
+    if (!getReading(reading)) {
+        return false;
     }
-    
-    return heading;
+    heading = reading.heading;
+    return true;
 }
 
-void Magnetometer::readRaw(float& x, float& y, float& z) {
-    sensors_event_t event;
-    mag.getEvent(&event);
-    x = event.magnetic.x;
-    y = event.magnetic.y;
-    z = event.magnetic.z;
+void Magnetometer::readRaw(float& x, float& y, float& z) const {
+    MagReading reading;
+    if (!getReading(reading)) {
+        reading.x = reading.y = reading.z = 0;
+    }
+    x = reading.x;
+    y = reading.y;
+    z = reading.z;
 }
 
 void Magnetometer::setPIDTunings(float kp, float ki, float kd) {
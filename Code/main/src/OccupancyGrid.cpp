@@ -0,0 +1,123 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  OccupancyGrid.cpp    */
+
+#include <string.h>
+#include "../include/OccupancyGrid.hpp"
+#include "../include/LidarScan.hpp"
+#include "../include/LidarGeometry.hpp"
+
+static inline int toCell(int32_t mm) {
+    return mm >= 0 ? mm / OccupancyGrid::CELL_SIZE : (mm - OccupancyGrid::CELL_SIZE + 1) / OccupancyGrid::CELL_SIZE;
+}
+
+OccupancyGrid::OccupancyGrid() {
+    clear();
+}
+
+void OccupancyGrid::clear() {
+    memset(cells, 0, sizeof(cells));
+    beams = 0;
+}
+
+void OccupancyGrid::setPose(int32_t x, int32_t y, int32_t heading) {
+    poseX = x;
+    poseY = y;
+    poseHeading = heading;
+}
+
+void OccupancyGrid::addPacket(const LidarPacket& packet) {
+    for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+        addBeam(LidarScanAssembler::pointAngle(packet, i), packet.distances[i]);
+    }
+}
+
+void OccupancyGrid::addBeam(uint16_t angle, uint16_t distance) {
+    if (distance == 0) {
+        return;  // No return, nothing to learn
+    }
+
+    bool hit = distance < MAX_RANGE;
+    if (!hit) {
+        distance = MAX_RANGE;
+    }
+
+    int32_t theta = (poseHeading - angle) % 36000;
+    if (theta < 0) {
+        theta += 36000;
+    }
+    int32_t endX = poseX + ((distance * LidarGeometry::cosQ15(theta)) >> 15);
+    int32_t endY = poseY + ((distance * LidarGeometry::sinQ15(theta)) >> 15);
+
+    trace(toCell(poseX), toCell(poseY), toCell(endX), toCell(endY), hit);
+    beams++;
+}
+
+void OccupancyGrid::trace(int x0, int y0, int x1, int y1, bool hit) {
+    if (x0 < 0 || x0 >= WIDTH || y0 < 0 || y0 >= HEIGHT) {
+        return;  // Sensor off the table
+    }
+
+    int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int dy = y1 > y0 ? y0 - y1 : y1 - y0;  // Negative, as in the all-octant Bresenham form
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int stepX = sx;
+    int stepY = sy * WIDTH;
+    int error = dx + dy;
+
+    int8_t* cell = &cells[y0 * WIDTH + x0];
+    int x = x0;
+    int y = y0;
+
+    while (x != x1 || y != y1) {
+        addLogOdds(*cell, LOG_ODDS_MISS);
+
+        int doubled = 2 * error;
+        if (doubled >= dy) {
+            error += dy;
+            x += sx;
+            cell += stepX;
+        }
+        if (doubled <= dx) {
+            error += dx;
+            y += sy;
+            cell += stepY;
+        }
+
+        // The table is convex, once the beam leaves it never comes back
+        if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) {
+            return;
+        }
+    }
+
+    if (hit) {
+        addLogOdds(*cell, LOG_ODDS_HIT);
+    }
+}
+
+void OccupancyGrid::addLogOdds(int8_t& cell, int8_t delta) {
+    int value = cell + delta;
+    if (value > LOG_ODDS_MAX) {
+        value = LOG_ODDS_MAX;
+    } else if (value < LOG_ODDS_MIN) {
+        value = LOG_ODDS_MIN;
+    }
+    cell = value;
+}
+
+bool OccupancyGrid::isOccupied(int32_t x, int32_t y) const {
+    int cx = x / CELL_SIZE;
+    int cy = y / CELL_SIZE;
+    if (x < 0 || y < 0 || cx >= WIDTH || cy >= HEIGHT) {
+        return true;  // Outside the table counts as wall
+    }
+    return getCell(cx, cy) > 0;
+}
@@ -0,0 +1,324 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  OpponentTracker.cpp    */
+
+#include <math.h>
+#include <string.h>
+#include "../include/OpponentTracker.hpp"
+#include "../include/LidarGeometry.hpp"
+#include "../include/OccupancyGrid.hpp"
+
+static const float TRACK_PI = 3.14159265f;
+
+OpponentTracker::OpponentTracker() {
+}
+
+void OpponentTracker::reset() {
+    trackCount = 0;
+    clusterCount = 0;
+    publish();
+}
+
+void OpponentTracker::setPose(float x, float y, float theta) {
+    poseX = x;
+    poseY = y;
+    poseTheta = theta * TRACK_PI / 180.0f;
+    poseValid = true;
+}
+
+void OpponentTracker::invalidatePose() {
+    poseValid = false;
+    publish();
+}
+
+int OpponentTracker::update(const LidarScan& scan, unsigned long now) {
+    if (!poseValid) {
+        return 0;
+    }
+    cluster(scan);
+
+    // Tracks left over from before a pose outage are not worth predicting
+    for (int i = trackCount - 1; i >= 0; i--) {
+        if (now - tracks[i].timestamp > maxTrackAge) {
+            removeTrack(i);
+        }
+    }
+
+    // Predict every track to now
+    float q = accelerationNoise * accelerationNoise;
+    for (int i = 0; i < trackCount; i++) {
+        OpponentTrack& track = tracks[i];
+        float dt = (now - track.timestamp) / 1000.0f;
+        track.x += track.vx * dt;
+        track.y += track.vy * dt;
+        float p00 = track.p00 + 2 * dt * track.p01 + dt * dt * track.p11 + q * dt * dt * dt * dt / 4;
+        float p01 = track.p01 + dt * track.p11 + q * dt * dt * dt / 2;
+        float p11 = track.p11 + q * dt * dt;
+        track.p00 = p00;
+        track.p01 = p01;
+        track.p11 = p11;
+        track.timestamp = now;
+    }
+
+    // Greedy nearest-neighbour association inside the gate
+    bool trackUsed[MAX_TRACKS] = {};
+    bool clusterUsed[MAX_CLUSTERS] = {};
+    float r = measurementNoise * measurementNoise;
+    while (true) {
+        int bestTrack = -1;
+        int bestCluster = -1;
+        float best = gate * gate;
+        for (int i = 0; i < trackCount; i++) {
+            if (trackUsed[i]) {
+                continue;
+            }
+            for (int j = 0; j < clusterCount; j++) {
+                if (clusterUsed[j]) {
+                    continue;
+                }
+                float dx = clusterX[j] - tracks[i].x;
+                float dy = clusterY[j] - tracks[i].y;
+                float d = dx * dx + dy * dy;
+                if (d < best) {
+                    best = d;
+                    bestTrack = i;
+                    bestCluster = j;
+                }
+            }
+        }
+        if (bestTrack < 0) {
+            break;
+        }
+        trackUsed[bestTrack] = true;
+        clusterUsed[bestCluster] = true;
+
+        OpponentTrack& track = tracks[bestTrack];
+        float s = track.p00 + r;
+        float k0 = track.p00 / s;
+        float k1 = track.p01 / s;
+        float innovationX = clusterX[bestCluster] - track.x;
+        float innovationY = clusterY[bestCluster] - track.y;
+        track.x += k0 * innovationX;
+        track.y += k0 * innovationY;
+        track.vx += k1 * innovationX;
+        track.vy += k1 * innovationY;
+        track.p11 -= k1 * track.p01;
+        track.p00 *= 1 - k0;
+        track.p01 *= 1 - k0;
+        if (track.hits < 255) {
+            track.hits++;
+        }
+        track.misses = 0;
+        if (track.hits >= confirmHits) {
+            track.confirmed = true;
+        }
+    }
+
+    // Age unmatched tracks, iterating backwards as removal swaps in the last one
+    for (int i = trackCount - 1; i >= 0; i--) {
+        if (!trackUsed[i] && ++tracks[i].misses > maxMisses) {
+            removeTrack(i);
+        }
+    }
+
+    // Start tracks on unmatched clusters
+    for (int j = 0; j < clusterCount && trackCount < MAX_TRACKS; j++) {
+        if (clusterUsed[j]) {
+            continue;
+        }
+        OpponentTrack& track = tracks[trackCount++];
+        track.x = clusterX[j];
+        track.y = clusterY[j];
+        track.vx = 0;
+        track.vy = 0;
+        track.p00 = r;
+        track.p01 = 0;
+        track.p11 = 1000.0f * 1000.0f;  // Unknown speed, up to about 1 m/s
+        track.id = nextId++;
+        track.hits = 1;
+        track.misses = 0;
+        track.confirmed = false;
+        track.timestamp = now;
+    }
+
+    // Other tasks only ever see a finished update
+    publish();
+
+    int confirmed = 0;
+    for (int i = 0; i < trackCount; i++) {
+        if (tracks[i].confirmed) {
+            confirmed++;
+        }
+    }
+    return confirmed;
+}
+
+void OpponentTracker::predict(int index, float seconds, float& x, float& y) const {
+    x = tracks[index].x + tracks[index].vx * seconds;
+    y = tracks[index].y + tracks[index].vy * seconds;
+}
+
+uint16_t OpponentTracker::nearestInCone(float heading, float halfWidth, float horizon, unsigned long now) const {
+    static const int STEPS = 4;
+    float nearest = 0xFFFF;
+    Snapshot current;
+    if (!snapshot.read(current)) {
+        return 0;  // Torn by a running update, brake rather than guess
+    }
+    if (!current.poseValid) {
+        return 0xFFFF;
+    }
+    float c = cosf(current.poseTheta);
+    float s = sinf(current.poseTheta);
+
+    for (int i = 0; i < current.trackCount; i++) {
+        const OpponentTrack& track = current.tracks[i];
+        long age = (long)(now - track.timestamp);  // Negative if updated since now was read
+        age = age < 0 ? 0 : age;
+        if (!track.confirmed || (unsigned long)age > maxTrackAge) {
+            continue;
+        }
+        for (int step = 0; step < STEPS; step++) {
+            float seconds = age / 1000.0f + horizon * step / (STEPS - 1);
+            float x = track.x + track.vx * seconds;
+            float y = track.y + track.vy * seconds;
+
+            // Table frame to sensor frame, then clockwise angle from forward
+            float dx = x - current.poseX;
+            float dy = y - current.poseY;
+            float sensorX = c * dx + s * dy;
+            float sensorY = -s * dx + c * dy;
+            float range = sqrtf(sensorX * sensorX + sensorY * sensorY);
+            float angle = atan2f(-sensorY, sensorX) * 180.0f / TRACK_PI;
+            float difference = fmodf(angle - heading + 540.0f, 360.0f) - 180.0f;
+            float extent = range > opponentRadius ? asinf(opponentRadius / range) * 180.0f / TRACK_PI : 90.0f;
+            if (fabsf(difference) > halfWidth + extent) {
+                continue;
+            }
+            float edge = range > opponentRadius ? range - opponentRadius : 0;
+            if (edge < nearest) {
+                nearest = edge;
+            }
+        }
+    }
+    return (uint16_t)nearest;
+}
+
+void OpponentTracker::cluster(const LidarScan& scan) {
+    clusterCount = 0;
+    float c = cosf(poseTheta);
+    float s = sinf(poseTheta);
+    float gap2 = clusterGap * clusterGap;
+
+    // Start on a dropped bin so no object is cut at 0 degrees
+    float x = 0;
+    float y = 0;
+    int start = 0;
+    while (start < LidarScan::BINS && project(scan, start, c, s, x, y)) {
+        start++;
+    }
+    if (start == LidarScan::BINS) {
+        return;  // Nothing but obstacles all around, no arena to separate from
+    }
+
+    float sumX = 0;
+    float sumY = 0;
+    float firstX = 0;
+    float firstY = 0;
+    float lastX = 0;
+    float lastY = 0;
+    int count = 0;
+
+    for (int n = 1; n <= LidarScan::BINS; n++) {
+        bool keep = project(scan, (start + n) % LidarScan::BINS, c, s, x, y);
+
+        if (keep && count > 0) {
+            float dx = x - lastX;
+            float dy = y - lastY;
+            if (dx * dx + dy * dy > gap2) {
+                addCluster(sumX, sumY, count, hypotf(lastX - firstX, lastY - firstY));
+                count = 0;
+            }
+        }
+        if (!keep) {
+            if (count > 0) {
+                addCluster(sumX, sumY, count, hypotf(lastX - firstX, lastY - firstY));
+            }
+            count = 0;
+            continue;
+        }
+
+        if (count == 0) {
+            sumX = 0;
+            sumY = 0;
+            firstX = x;
+            firstY = y;
+        }
+        sumX += x;
+        sumY += y;
+        lastX = x;
+        lastY = y;
+        count++;
+    }
+}
+
+bool OpponentTracker::project(const LidarScan& scan, int bin, float c, float s, float& x, float& y) const {
+    if (scan.distances[bin] < minValidDist) {
+        return false;
+    }
+    uint32_t angle = bin * LidarScan::BIN_WIDTH + LidarScan::BIN_WIDTH / 2;
+    float sensorX = scan.distances[bin] * LidarGeometry::cosQ15(angle) / (float)LidarGeometry::ONE;
+    float sensorY = -scan.distances[bin] * LidarGeometry::sinQ15(angle) / (float)LidarGeometry::ONE;
+    x = poseX + c * sensorX - s * sensorY;
+    y = poseY + s * sensorX + c * sensorY;
+    return !isArena(x, y);
+}
+
+void OpponentTracker::addCluster(float sumX, float sumY, int count, float width) {
+    if (count < 2 || width < minClusterWidth || width > maxClusterWidth || clusterCount >= MAX_CLUSTERS) {
+        return;
+    }
+    // The lidar sees the near face, move back to the opponent's centre
+    float x = sumX / count;
+    float y = sumY / count;
+    float dx = x - poseX;
+    float dy = y - poseY;
+    float range = hypotf(dx, dy);
+    if (range > 0) {
+        x += opponentRadius * dx / range;
+        y += opponentRadius * dy / range;
+    }
+    clusterX[clusterCount] = x;
+    clusterY[clusterCount] = y;
+    clusterCount++;
+}
+
+bool OpponentTracker::isArena(float x, float y) const {
+    // Borders, beacon supports and anything outside the table
+    return x < borderMargin || y < borderMargin ||
+           x > OccupancyGrid::TABLE_WIDTH - borderMargin ||
+           y > OccupancyGrid::TABLE_HEIGHT - borderMargin;
+}
+
+void OpponentTracker::removeTrack(int index) {
+    tracks[index] = tracks[trackCount - 1];
+    trackCount--;
+}
+
+void OpponentTracker::publish() {
+    Snapshot next;
+    memcpy(next.tracks, tracks, trackCount * sizeof(OpponentTrack));
+    next.trackCount = trackCount;
+    next.poseX = poseX;
+    next.poseY = poseY;
+    next.poseTheta = poseTheta;
+    next.poseValid = poseValid;
+    snapshot.write(next);
+}
@@ -0,0 +1,141 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  PosePredictor.cpp    */
+
+#include <math.h>
+#include "../include/PosePredictor.hpp"
+
+PosePredictor::PosePredictor() {
+    reset();
+}
+
+void PosePredictor::reset() {
+    motionHead = 0;
+    motionCount = 0;
+    velocityX = 0;
+    velocityY = 0;
+    fixHead = 0;
+    fixCount = 0;
+    offsetX = 0;
+    offsetY = 0;
+    correctionX = 0;
+    correctionY = 0;
+}
+
+void PosePredictor::addMotion(float vx, float vy, uint32_t now) {
+    Sample sample = {now, 0, 0};
+    displacement(now, sample.x, sample.y);
+    motion[motionHead] = sample;
+    motionHead = (motionHead + 1) % MOTION_SAMPLES;
+    if (motionCount < MOTION_SAMPLES) {
+        motionCount++;
+    }
+    velocityX = vx;
+    velocityY = vy;
+}
+
+void PosePredictor::displacement(uint32_t time, float& x, float& y) const {
+    if (motionCount == 0) {
+        x = 0;
+        y = 0;
+        return;
+    }
+
+    // Newest first: past the last sample the current command still applies
+    int index = (motionHead + MOTION_SAMPLES - 1) % MOTION_SAMPLES;
+    const Sample& last = motion[index];
+    if ((int32_t)(time - last.time) >= 0) {
+        float dt = (time - last.time) * 0.001f;
+        x = last.x + velocityX * dt;
+        y = last.y + velocityY * dt;
+        return;
+    }
+    for (int i = 1; i < motionCount; i++) {
+        const Sample& later = motion[index];
+        index = (index + MOTION_SAMPLES - 1) % MOTION_SAMPLES;
+        const Sample& earlier = motion[index];
+        if ((int32_t)(time - earlier.time) >= 0) {
+            float t = later.time == earlier.time ? 1.0f : (float)(time - earlier.time) / (later.time - earlier.time);
+            x = earlier.x + (later.x - earlier.x) * t;
+            y = earlier.y + (later.y - earlier.y) * t;
+            return;
+        }
+    }
+    x = motion[index].x;  // Older than the track, hold its oldest point
+    y = motion[index].y;
+}
+
+void PosePredictor::addFix(float x, float y, uint32_t received) {
+    uint32_t measured = received - latency;
+    float dx, dy;
+    displacement(measured, dx, dy);
+    residuals[fixHead] = {measured, x - dx, y - dy};
+    fixHead = (fixHead + 1) % MAX_FIXES;
+    if (fixCount < MAX_FIXES) {
+        fixCount++;
+    }
+    fit();
+}
+
+void PosePredictor::fit() {
+    // Least squares line per axis over the fixes inside the window, time
+    // relative to the newest fix
+    int newest = (fixHead + MAX_FIXES - 1) % MAX_FIXES;
+    fitTime = residuals[newest].time;
+
+    float sumT = 0, sumTT = 0, sumX = 0, sumY = 0, sumTX = 0, sumTY = 0;
+    int n = 0;
+    for (int i = 0; i < fixCount; i++) {
+        const Sample& fix = residuals[(newest + MAX_FIXES - i) % MAX_FIXES];
+        uint32_t age = fitTime - fix.time;
+        if (age > window) {
+            break;
+        }
+        float t = -(float)age * 0.001f;
+        sumT += t;
+        sumTT += t * t;
+        sumX += fix.x;
+        sumY += fix.y;
+        sumTX += t * fix.x;
+        sumTY += t * fix.y;
+        n++;
+    }
+
+    float det = n * sumTT - sumT * sumT;
+    if (n < 3 || det < 1e-4f) {
+        // Too few fixes for a slope, follow the newest one
+        offsetX = residuals[newest].x;
+        offsetY = residuals[newest].y;
+        correctionX = 0;
+        correctionY = 0;
+        return;
+    }
+    correctionX = (n * sumTX - sumT * sumX) / det;
+    correctionY = (n * sumTY - sumT * sumY) / det;
+    float speed = sqrtf(correctionX * correctionX + correctionY * correctionY);
+    if (speed > maxCorrection) {
+        correctionX *= maxCorrection / speed;
+        correctionY *= maxCorrection / speed;
+    }
+    offsetX = (sumX - correctionX * sumT) / n;
+    offsetY = (sumY - correctionY * sumT) / n;
+}
+
+bool PosePredictor::predict(uint32_t now, float& x, float& y) const {
+    if (fixCount == 0) {
+        return false;
+    }
+    float dx, dy;
+    displacement(now, dx, dy);
+    float dt = (int32_t)(now - fitTime) * 0.001f;
+    x = dx + offsetX + correctionX * dt;
+    y = dy + offsetY + correctionY * dt;
+    return true;
+}
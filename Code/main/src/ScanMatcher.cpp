@@ -0,0 +1,256 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  ScanMatcher.cpp    */
+
+#include <math.h>
+#include <string.h>
+#include "../include/ScanMatcher.hpp"
+#include "../include/LidarGeometry.hpp"
+
+static const float MATCH_PI = 3.14159265f;
+
+static inline int floorCell(float v) {
+    return (int)floorf(v / ScanMatcher::CELL_SIZE);
+}
+
+// Solves the symmetric 3x3 system A x = b, returns false if A is singular
+static bool solve3(const float A[3][3], const float b[3], float x[3], float inverse[3][3]) {
+    float c00 = A[1][1] * A[2][2] - A[1][2] * A[2][1];
+    float c01 = A[1][2] * A[2][0] - A[1][0] * A[2][2];
+    float c02 = A[1][0] * A[2][1] - A[1][1] * A[2][0];
+    float det = A[0][0] * c00 + A[0][1] * c01 + A[0][2] * c02;
+    if (fabsf(det) < 1e-9f) {
+        return false;
+    }
+    float d = 1.0f / det;
+    inverse[0][0] = c00 * d;
+    inverse[0][1] = (A[0][2] * A[2][1] - A[0][1] * A[2][2]) * d;
+    inverse[0][2] = (A[0][1] * A[1][2] - A[0][2] * A[1][1]) * d;
+    inverse[1][0] = c01 * d;
+    inverse[1][1] = (A[0][0] * A[2][2] - A[0][2] * A[2][0]) * d;
+    inverse[1][2] = (A[0][2] * A[1][0] - A[0][0] * A[1][2]) * d;
+    inverse[2][0] = c02 * d;
+    inverse[2][1] = (A[0][1] * A[2][0] - A[0][0] * A[2][1]) * d;
+    inverse[2][2] = (A[0][0] * A[1][1] - A[0][1] * A[1][0]) * d;
+    for (int i = 0; i < 3; i++) {
+        x[i] = inverse[i][0] * b[0] + inverse[i][1] * b[1] + inverse[i][2] * b[2];
+    }
+    return true;
+}
+
+ScanMatcher::ScanMatcher() {
+    reset();
+}
+
+void ScanMatcher::reset() {
+    refCount = 0;
+    pointCount = 0;
+    memset(&result, 0, sizeof(result));
+    odometryX = 0;
+    odometryY = 0;
+    odometryTheta = 0;
+    velocityX = 0;
+    velocityY = 0;
+    angularVelocity = 0;
+}
+
+bool ScanMatcher::hold(const LidarScan& scan) {
+    if (refCount == 0) {
+        return match(scan);
+    }
+
+    // Keep the older reference so small motions still add up against it. Its
+    // timestamp stays too: the next match() spreads the motion gathered since
+    // the reference over the whole time, not over one revolution
+    result.x = 0;
+    result.y = 0;
+    result.theta = 0;
+    result.valid = true;
+    velocityX = 0;
+    velocityY = 0;
+    angularVelocity = 0;
+    return true;
+}
+
+bool ScanMatcher::match(const LidarScan& scan) {
+    collect(scan);
+
+    // Constant velocity guess: start from the previous increment
+    float x = result.valid ? result.x : 0;
+    float y = result.valid ? result.y : 0;
+    float theta = result.valid ? result.theta : 0;
+    result.valid = false;
+
+    float H[3][3];
+    float inverse[3][3];
+    float sumSquares = 0;
+    int used = 0;
+    bool solved = refCount > 0;
+
+    for (int iteration = 0; iteration < ITERATIONS && solved; iteration++) {
+        float g[3] = {0, 0, 0};
+        memset(H, 0, sizeof(H));
+        sumSquares = 0;
+        used = 0;
+
+        float c = cosf(theta);
+        float s = sinf(theta);
+
+        for (int i = 0; i < pointCount; i++) {
+            float px = pointX[i];
+            float py = pointY[i];
+            float tx = c * px - s * py + x;
+            float ty = s * px + c * py + y;
+
+            int j = nearest(tx, ty);
+            if (j < 0) {
+                continue;
+            }
+
+            float nx = refNormalX[j];
+            float ny = refNormalY[j];
+            float r = nx * (tx - refX[j]) + ny * (ty - refY[j]);
+            if (fabsf(r) > outlierDistance) {
+                continue;
+            }
+
+            // d r / d (x, y, theta)
+            float J[3] = {nx, ny, nx * (-s * px - c * py) + ny * (c * px - s * py)};
+            for (int a = 0; a < 3; a++) {
+                g[a] += J[a] * r;
+                for (int b = 0; b < 3; b++) {
+                    H[a][b] += J[a] * J[b];
+                }
+            }
+            sumSquares += r * r;
+            used++;
+        }
+
+        float delta[3];
+        if (used < minCorrespondences || !solve3(H, g, delta, inverse)) {
+            solved = false;
+            break;
+        }
+        x -= delta[0];
+        y -= delta[1];
+        theta -= delta[2];
+    }
+
+    if (solved && used >= minCorrespondences) {
+        float variance = sumSquares / (used > 3 ? used - 3 : 1);
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) {
+                result.covariance[a][b] = variance * inverse[a][b];
+            }
+        }
+        result.x = x;
+        result.y = y;
+        result.theta = theta;
+        result.rms = sqrtf(sumSquares / used);
+        result.correspondences = used;
+        result.valid = true;
+
+        // Compose the increment into the odometry
+        float c = cosf(odometryTheta);
+        float s = sinf(odometryTheta);
+        odometryX += c * x - s * y;
+        odometryY += s * x + c * y;
+        odometryTheta = remainderf(odometryTheta + theta, 2.0f * MATCH_PI);
+    }
+
+    uint16_t period = LidarScan::elapsed(lastTimestamp, scan.endTimestamp);
+    if (result.valid && period > 0) {
+        velocityX = x * 1000.0f / period;
+        velocityY = y * 1000.0f / period;
+        angularVelocity = theta * 1000.0f / period;
+    } else {
+        velocityX = 0;
+        velocityY = 0;
+        angularVelocity = 0;
+    }
+    lastTimestamp = scan.endTimestamp;
+
+    buildReference();
+    return result.valid;
+}
+
+void ScanMatcher::collect(const LidarScan& scan) {
+    LidarGeometry::deskewScan(scan, velocityX, velocityY, angularVelocity, binX, binY);
+    pointCount = 0;
+    for (int bin = 0; bin < LidarScan::BINS; bin++) {
+        if (scan.distances[bin] >= minValidDist) {
+            pointX[pointCount] = binX[bin];
+            pointY[pointCount] = binY[bin];
+            pointCount++;
+        }
+    }
+}
+
+void ScanMatcher::buildReference() {
+    // The current scan becomes the reference for the next one
+    for (int i = 0; i < HASH_SIZE; i++) {
+        buckets[i] = -1;
+    }
+    refCount = 0;
+
+    float gap2 = gapThreshold * gapThreshold;
+    for (int i = 1; i + 1 < pointCount; i++) {
+        float ax = pointX[i - 1], ay = pointY[i - 1];
+        float bx = pointX[i + 1], by = pointY[i + 1];
+        float dxa = pointX[i] - ax, dya = pointY[i] - ay;
+        float dxb = bx - pointX[i], dyb = by - pointY[i];
+        if (dxa * dxa + dya * dya > gap2 || dxb * dxb + dyb * dyb > gap2) {
+            continue;  // Isolated point, no reliable normal
+        }
+        float tx = bx - ax;
+        float ty = by - ay;
+        float norm = sqrtf(tx * tx + ty * ty);
+        if (norm <= 0) {
+            continue;
+        }
+
+        refX[refCount] = pointX[i];
+        refY[refCount] = pointY[i];
+        refNormalX[refCount] = -ty / norm;
+        refNormalY[refCount] = tx / norm;
+
+        int h = hash(floorCell(pointX[i]), floorCell(pointY[i]));
+        refNext[refCount] = buckets[h];
+        buckets[h] = refCount;
+        refCount++;
+    }
+}
+
+int ScanMatcher::nearest(float x, float y) const {
+    int cx = floorCell(x);
+    int cy = floorCell(y);
+    int best = -1;
+    float bestDistance = (float)CELL_SIZE * CELL_SIZE;
+
+    for (int ox = -1; ox <= 1; ox++) {
+        for (int oy = -1; oy <= 1; oy++) {
+            for (int j = buckets[hash(cx + ox, cy + oy)]; j >= 0; j = refNext[j]) {
+                float dx = refX[j] - x;
+                float dy = refY[j] - y;
+                float d = dx * dx + dy * dy;
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    best = j;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+int ScanMatcher::hash(int cx, int cy) {
+    // Unsigned before multiplying: signed overflow is undefined from 3 m at 100 mm cells
+    return (((unsigned)cx * 73856093u) ^ ((unsigned)cy * 19349663u)) & (HASH_SIZE - 1);
+}
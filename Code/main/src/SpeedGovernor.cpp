@@ -0,0 +1,63 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  SpeedGovernor.cpp    */
+
+#include <math.h>
+#include "../include/SpeedGovernor.hpp"
+
+SpeedGovernor::SpeedGovernor() {
+    reset();
+}
+
+void SpeedGovernor::reset() {
+    allowed = maxSpeed;
+    timeToCollision = 0;
+    scale = 1;
+    lastTime = 0;
+}
+
+int SpeedGovernor::limit(int speed, uint16_t range, unsigned long now) {
+    float deltaTime = (lastTime == 0) ? 0 : (now - lastTime) / 1000.0f;
+    lastTime = now;
+
+    float commanded = speed * maxSpeed / 100.0f;
+    float freeDistance = range - stopDistance;
+    if (freeDistance < 0) {
+        freeDistance = 0;
+    }
+
+    // Largest v with v * reactionTime + v^2 / (2 * deceleration) <= freeDistance
+    float a = deceleration;
+    float braking = a * (sqrtf(reactionTime * reactionTime + 2.0f * freeDistance / a) - reactionTime);
+
+    // Keep at least minTimeToCollision before reaching the stop distance
+    float timeLimited = freeDistance / minTimeToCollision;
+
+    float target = braking < timeLimited ? braking : timeLimited;
+
+    // Brake immediately, recover at the acceleration limit so speed does not pump
+    if (target < allowed) {
+        allowed = target;
+    } else {
+        allowed += acceleration * deltaTime;
+        if (allowed > target) {
+            allowed = target;
+        }
+    }
+
+    timeToCollision = (commanded > 0) ? freeDistance / commanded : INFINITY;
+
+    if (commanded <= allowed) {
+        scale = 1;
+        return speed;
+    }
+    scale = allowed / commanded;
+    return (int)(allowed * 100.0f / maxSpeed);
+}
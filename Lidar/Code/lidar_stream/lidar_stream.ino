@@ -0,0 +1,86 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  lidar_stream.ino    */
+
+// Bench sketch for a single LD06: streams it to the host over USB CDC in the
+// LidarStream binary framing, read by the Lidar tab of the Qt application.
+// The driver is the robot firmware's own, copied into src/driver by
+// sync_driver.sh because Arduino builds only see the sketch folder.
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include "USB.h"
+
+#include "src/driver/include/Lidar.hpp"
+#include "src/driver/include/LidarStream.hpp"
+
+#define PIN_LED 21
+#define PIN_LIDAR 18
+#define STREAM_MODE LidarStream::POINTS  // Host switches with 'R' (raw frames) or 'P' (points)
+#define MIN_DISTANCE 150                 // mm, LED turns red below
+
+Adafruit_NeoPixel pixels(1, PIN_LED, NEO_GRB + NEO_KHZ800);
+USBCDC USBSerial;
+HardwareSerial SerialLidar(1);
+Lidar lidar(SerialLidar, PIN_LIDAR);
+LidarStream stream(STREAM_MODE);
+uint32_t droppedBytes = 0;
+
+void writeUSB(const uint8_t* data, size_t length, void* context) {
+    // Never block the lidar on a slow host: drop whole frames instead
+    if (USBSerial.availableForWrite() < (int)length) {
+        droppedBytes += length;
+        return;
+    }
+    USBSerial.write(data, length);
+}
+
+void onLidarPacket(const LidarPacket& packet, void* context) {
+    stream.addPacket(packet);
+}
+
+void colorPixel(int redColor, int greenColor, int blueColor) {
+    pixels.setPixelColor(0, pixels.Color(redColor, greenColor, blueColor));
+    pixels.show();
+}
+
+void setup() {
+    USBSerial.begin();
+    USB.begin();
+
+    pixels.begin();
+    pixels.clear();
+    pixels.setBrightness(10);
+    colorPixel(0, 0, 255);
+
+    stream.setWriter(writeUSB, NULL);
+    lidar.setPacketListener(onLidarPacket, NULL);
+    lidar.init();
+}
+
+void loop() {
+    while (USBSerial.available() > 0) {
+        int command = USBSerial.read();
+        if (command == 'R') {
+            stream.setMode(LidarStream::RAW);
+        } else if (command == 'P') {
+            stream.setMode(LidarStream::POINTS);
+        }
+    }
+
+    if (lidar.update()) {
+        if (lidar.nearestInCone(0, 180) < MIN_DISTANCE) {
+            colorPixel(255, 0, 0);
+        } else {
+            colorPixel(0, 255, 0);
+        }
+    }
+    delay(2);
+}
@@ -0,0 +1,56 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarFilter.hpp    */
+
+#ifndef LIDARFILTER_HPP
+#define LIDARFILTER_HPP
+
+#include <stdint.h>
+#include "LidarScan.hpp"
+
+// Streaming outlier filter over the last HISTORY returns of every 0.5 degree
+// bin. A point is kept if it agrees with the median of its bin's history (the
+// tolerance grows with the median absolute deviation), or with the latest
+// return of its bin or of a neighbouring bin, so new obstacles pass as soon as
+// they show up in two places. Each bin also has a confidence that rises on
+// agreeing returns and halves on rejected ones. Constant work per point.
+class LidarFilter {
+public:
+    static const int HISTORY = 5;  // Revolutions, the median uses a fixed sorting network
+
+    LidarFilter();
+
+    bool addPoint(uint16_t angle, uint16_t distance);  // 0.01 degrees and mm, returns true if kept
+    void reset();
+
+    uint8_t getConfidence(int bin) const { return confidence[bin]; }  // 0-255
+    uint8_t getConfidenceAt(uint16_t angle) const { return confidence[(angle / LidarScan::BIN_WIDTH) % LidarScan::BINS]; }
+    uint32_t getRejected() const { return rejected; }
+
+    void setMinValidDistance(uint16_t distance) { minValidDist = distance; }
+    void setTolerance(uint16_t mm, uint8_t percent) { minTolerance = mm; relativeTolerance = percent; }
+
+private:
+    uint16_t history[LidarScan::BINS][HISTORY];
+    uint8_t head[LidarScan::BINS];   // Next slot to write
+    uint8_t filled[LidarScan::BINS]; // Valid slots, up to HISTORY
+    uint8_t confidence[LidarScan::BINS];
+    uint32_t rejected = 0;
+
+    uint16_t minValidDist = 60;      // mm, closer returns hit the robot itself
+    uint16_t minTolerance = 30;      // mm
+    uint8_t relativeTolerance = 5;   // Percent of the distance
+
+    uint16_t latest(int bin) const;
+    uint16_t tolerance(uint16_t distance, uint16_t spread) const;
+    static uint16_t median5(uint16_t a, uint16_t b, uint16_t c, uint16_t d, uint16_t e);
+};
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarScan.hpp    */
+
+#ifndef LIDARSCAN_HPP
+#define LIDARSCAN_HPP
+
+#include <stdint.h>
+#include "LidarFramer.hpp"
+
+// One full revolution binned into a fixed-resolution polar array
+struct LidarScan {
+    static const int BINS = 720;       // 0.5 degree resolution
+    static const int BIN_WIDTH = 50;   // 0.01 degrees per bin
+    static const uint16_t TIMESTAMP_WRAP = 30000;  // LD06 timestamps count ms modulo 30 s
+
+    uint16_t distances[BINS];   // mm, 0 = no return in this bin
+    uint8_t intensities[BINS];
+    uint8_t offsets[BINS];      // ms from startTimestamp to the packet of the kept return
+    uint16_t pointCount;        // Points binned during the revolution
+    uint16_t speed;             // Degrees per second, from the last packet
+    uint16_t startTimestamp;    // Sensor ms of the first packet
+    uint16_t endTimestamp;      // Sensor ms of the last packet
+    uint32_t sequence;          // Increments for every published revolution
+
+    static uint16_t elapsed(uint16_t from, uint16_t to) { return (to + TIMESTAMP_WRAP - from) % TIMESTAMP_WRAP; }
+    uint16_t duration() const { return elapsed(startTimestamp, endTimestamp); }  // ms
+};
+
+// Bins LD06 packets into revolutions and publishes each completed one by
+// swapping buffers. Readers get a reference to the published scan without
+// copying or locking; it stays valid until the next revolution completes
+// (~100 ms), check getSequence() afterwards to detect an overrun.
+class LidarScanAssembler {
+public:
+    LidarScanAssembler();
+
+    void addPacket(const LidarPacket& packet);
+    void reset();
+
+    const LidarScan& getScan() const { return buffers[front]; }  // Last complete revolution
+    uint32_t getSequence() const { return buffers[front].sequence; }
+
+    static uint16_t pointAngle(const LidarPacket& packet, int index);  // 0.01 degrees, interpolated
+
+private:
+    LidarScan buffers[2];
+    volatile uint8_t front;  // Index of the published buffer, single byte so the swap is atomic
+    LidarScan* back;         // Revolution being filled
+    uint16_t lastAngle;
+    bool started;            // Skip the partial revolution after reset
+
+    void beginRevolution();
+    void publish();
+};
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarSectors.hpp    */
+
+#ifndef LIDARSECTORS_HPP
+#define LIDARSECTORS_HPP
+
+#include <stdint.h>
+
+// Minimum distance per angular sector, updated point by point as the sensor
+// sweeps. A sparse table over the circular sector array answers "nearest
+// obstacle within +-N degrees of heading X" with two lookups.
+class LidarSectors {
+public:
+    static const int SECTORS = 72;        // 5 degrees each
+    static const int SECTOR_WIDTH = 500;  // 0.01 degrees
+    static const int LEVELS = 7;          // 2^6 = 64 sectors for the widest window
+    static const uint16_t CLEAR = 0xFFFF; // No obstacle in range
+
+    LidarSectors();
+
+    void addPoint(uint16_t angle, uint16_t distance);  // Sensor frame, 0.01 degrees and mm
+    void reset();
+
+    // Nearest distance (mm) within +-halfWidth degrees of heading (robot frame, degrees)
+    uint16_t nearest(float heading, float halfWidth) const;
+    uint16_t getSector(int sector) const { return table[0][sector]; }
+
+    void setMountAngle(float degrees) { mountAngle = degrees; }  // Sensor 0 degrees relative to robot forward
+    void setMinValidDistance(uint16_t distance) { minValidDist = distance; }
+
+private:
+    uint16_t table[LEVELS][SECTORS];  // table[k][i] = min of sectors i .. i + 2^k - 1
+    uint16_t pending;                 // Minimum of the sector being swept
+    int currentSector;
+    float mountAngle = 0;
+    uint16_t minValidDist = 60;       // Closer returns hit the robot itself
+
+    void commit(int sector, uint16_t distance);
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarStream.hpp    */
+
+#ifndef LIDARSTREAM_HPP
+#define LIDARSTREAM_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LidarFramer.hpp"
+
+// Binary framing for streaming lidar data over USB CDC:
+//   0xA5 0x5A | type | length (uint16 LE) | payload | CRC8 of type..payload
+// TYPE_FRAME carries one verbatim 47-byte LD06 frame (recording and replay),
+// TYPE_POINTS a batch of returns: timestamp, speed, count, then per point
+// angle (0.01 degrees), distance (mm) and intensity, little endian.
+
+// Points decoded from either frame type
+struct LidarPointBatch {
+    static const int MAX_POINTS = 48;
+
+    uint16_t timestamp;  // Sensor ms of the first packet in the batch
+    uint16_t speed;      // Degrees per second
+    uint8_t count;
+    uint16_t angles[MAX_POINTS];
+    uint16_t distances[MAX_POINTS];
+    uint8_t intensities[MAX_POINTS];
+};
+
+class LidarStream {
+public:
+    typedef void (*Writer)(const uint8_t* data, size_t length, void* context);
+
+    enum Mode : uint8_t {
+        RAW = 0,   // Every LD06 frame, about 18 KB/s
+        POINTS,    // Non-zero returns only, 5 bytes each
+    };
+
+    enum Type : uint8_t {
+        TYPE_FRAME = 0x01,
+        TYPE_POINTS = 0x02,
+    };
+
+    static const uint8_t SYNC1 = 0xA5;
+    static const uint8_t SYNC2 = 0x5A;
+    static const int HEADER_SIZE = 5;
+    static const int POINT_SIZE = 5;
+    static const int MAX_PAYLOAD = 5 + POINT_SIZE * LidarPointBatch::MAX_POINTS;
+
+    LidarStream(Mode mode = POINTS);
+
+    void setWriter(Writer writer, void* context) { this->writer = writer; writerContext = context; }
+    void setMode(Mode mode);
+    Mode getMode() const { return mode; }
+
+    void addPacket(const LidarPacket& packet);
+    void flush();  // Sends a partial point batch
+
+    static void encodeFrame(const LidarPacket& packet, uint8_t* frame);  // LD06 layout, CRC included
+
+private:
+    Mode mode;
+    Writer writer = nullptr;
+    void* writerContext = nullptr;
+    LidarPointBatch pending;
+    uint8_t out[HEADER_SIZE + MAX_PAYLOAD + 1];
+
+    void send(Type type, size_t length);  // Payload already in out + HEADER_SIZE
+};
+
+// Incremental decoder for the stream above, same calling pattern as LidarFramer
+class LidarStreamDecoder {
+public:
+    typedef void (*BatchHandler)(const LidarPointBatch& batch, void* context);
+
+    LidarStreamDecoder();
+
+    size_t parse(const uint8_t* data, size_t length, BatchHandler handler, void* context);  // Returns batches decoded
+    void reset();
+
+    uint32_t getFrameCount() const { return frameCount; }
+    uint32_t getCrcErrors() const { return crcErrors; }
+
+private:
+    uint8_t rx[LidarStream::HEADER_SIZE + LidarStream::MAX_PAYLOAD + 1];
+    size_t rxLength;
+    size_t expected;  // Total frame size once the header is in
+    uint32_t frameCount;
+    uint32_t crcErrors;
+
+    bool dispatch(BatchHandler handler, void* context);
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  Lidar.cpp    */
+
+#include <Arduino.h>
+#include "../include/Lidar.hpp"
+
+Lidar::Lidar(HardwareSerial& serialPort, int rxPin, long baudRate)
+    : serial(serialPort),
+      rxPin(rxPin) {
+    memset(&packet, 0, sizeof(packet));
+    sectors.setMinValidDistance(minValidDist);
+    filter.setMinValidDistance(minValidDist);
+}
+
+Lidar::~Lidar() {
+}
+
+bool Lidar::init() {
+    serial.setRxBufferSize(RX_BUFFER_SIZE);  // Must be set before begin()
+    serial.begin(230400, SERIAL_8N1, rxPin, -1);  // RX on specified pin, TX not used
+    health.begin(millis());
+    return true;  // No hardware check, assume success
+}
+
+bool Lidar::update() {
+    uint32_t framesBefore = framer.getFrameCount();
+    uint32_t scanBefore = scans.getSequence();
+
+    // Non-blocking reads straight out of the UART driver's ring buffer
+    int available;
+    while ((available = serial.available()) > 0) {
+        size_t bytesRead = serial.read(rxChunk, min(available, (int)RX_CHUNK_SIZE));
+        if (bytesRead == 0) {
+            break;
+        }
+        framer.parse(rxChunk, bytesRead, onPacket, this);
+    }
+
+    unsigned long now = millis();
+    if (scans.getSequence() != scanBefore) {
+        scanTime = now;
+    }
+    health.update(now, framer.getFrameCount(), framer.getCrcErrors());
+
+    return framer.getFrameCount() != framesBefore;
+}
+
+void Lidar::onPacket(const LidarPacket& packet, void* context) {
+    Lidar* lidar = static_cast<Lidar*>(context);
+    lidar->packet = packet;
+    lidar->health.addPacket(packet);
+
+    // Rejected returns become empty ones: the sectors and the revolutions
+    // (odometry, walls, posts, opponents, summaries) only see kept points
+    LidarPacket filtered = packet;
+    for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+        uint16_t angle = LidarScanAssembler::pointAngle(packet, i);
+        if (!lidar->filter.addPoint(angle, packet.distances[i])) {
+            filtered.distances[i] = 0;
+        }
+        lidar->sectors.addPoint(angle, filtered.distances[i]);  // Still advances the sweep
+    }
+    lidar->scans.addPacket(filtered);
+
+    // Listeners get the packet as received, recordings stay raw
+    if (lidar->listener) {
+        lidar->listener(packet, lidar->listenerContext);
+    }
+}
+
+bool Lidar::tooClose(float heading, float halfWidth) {
+    return sectors.nearest(heading, halfWidth) < thresholdDist;
+}
\ No newline at end of file
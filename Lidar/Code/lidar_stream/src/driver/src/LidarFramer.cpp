@@ -0,0 +1,170 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarFramer.cpp    */
+
+#include <string.h>
+#include "../include/LidarFramer.hpp"
+
+const uint8_t LidarFramer::CrcTable[256] = {
+    0x00, 0x4d, 0x9a, 0xd7, 0x79, 0x34, 0xe3, 0xae, 0xf2, 0xbf, 0x68, 0x25,
+    0x8b, 0xc6, 0x11, 0x5c, 0xa9, 0xe4, 0x33, 0x7e, 0xd0, 0x9d, 0x4a, 0x07,
+    0x5b, 0x16, 0xc1, 0x8c, 0x22, 0x6f, 0xb8, 0xf5, 0x1f, 0x52, 0x85, 0xc8,
+    0x66, 0x2b, 0xfc, 0xb1, 0xed, 0xa0, 0x77, 0x3a, 0x94, 0xd9, 0x0e, 0x43,
+    0xb6, 0xfb, 0x2c, 0x61, 0xcf, 0x82, 0x55, 0x18, 0x44, 0x09, 0xde, 0x93,
+    0x3d, 0x70, 0xa7, 0xea, 0x3e, 0x73, 0xa4, 0xe9, 0x47, 0x0a, 0xdd, 0x90,
+    0xcc, 0x81, 0x56, 0x1b, 0xb5, 0xf8, 0x2f, 0x62, 0x97, 0xda, 0x0d, 0x40,
+    0xee, 0xa3, 0x74, 0x39, 0x65, 0x28, 0xff, 0xb2, 0x1c, 0x51, 0x86, 0xcb,
+    0x21, 0x6c, 0xbb, 0xf6, 0x58, 0x15, 0xc2, 0x8f, 0xd3, 0x9e, 0x49, 0x04,
+    0xaa, 0xe7, 0x30, 0x7d, 0x88, 0xc5, 0x12, 0x5f, 0xf1, 0xbc, 0x6b, 0x26,
+    0x7a, 0x37, 0xe0, 0xad, 0x03, 0x4e, 0x99, 0xd4, 0x7c, 0x31, 0xe6, 0xab,
+    0x05, 0x48, 0x9f, 0xd2, 0x8e, 0xc3, 0x14, 0x59, 0xf7, 0xba, 0x6d, 0x20,
+    0xd5, 0x98, 0x4f, 0x02, 0xac, 0xe1, 0x36, 0x7b, 0x27, 0x6a, 0xbd, 0xf0,
+    0x5e, 0x13, 0xc4, 0x89, 0x63, 0x2e, 0xf9, 0xb4, 0x1a, 0x57, 0x80, 0xcd,
+    0x91, 0xdc, 0x0b, 0x46, 0xe8, 0xa5, 0x72, 0x3f, 0xca, 0x87, 0x50, 0x1d,
+    0xb3, 0xfe, 0x29, 0x64, 0x38, 0x75, 0xa2, 0xef, 0x41, 0x0c, 0xdb, 0x96,
+    0x42, 0x0f, 0xd8, 0x95, 0x3b, 0x76, 0xa1, 0xec, 0xb0, 0xfd, 0x2a, 0x67,
+    0xc9, 0x84, 0x53, 0x1e, 0xeb, 0xa6, 0x71, 0x3c, 0x92, 0xdf, 0x08, 0x45,
+    0x19, 0x54, 0x83, 0xce, 0x60, 0x2d, 0xfa, 0xb7, 0x5d, 0x10, 0xc7, 0x8a,
+    0x24, 0x69, 0xbe, 0xf3, 0xaf, 0xe2, 0x35, 0x78, 0xd6, 0x9b, 0x4c, 0x01,
+    0xf4, 0xb9, 0x6e, 0x23, 0x8d, 0xc0, 0x17, 0x5a, 0x06, 0x4b, 0x9c, 0xd1,
+    0x7f, 0x32, 0xe5, 0xa8
+};
+
+LidarFramer::LidarFramer()
+    : frameLength(0),
+      hunting(false),
+      frameCount(0),
+      crcErrors(0),
+      resyncs(0) {
+}
+
+void LidarFramer::reset() {
+    frameLength = 0;
+    hunting = false;
+    frameCount = 0;
+    crcErrors = 0;
+    resyncs = 0;
+}
+
+size_t LidarFramer::parse(const uint8_t* data, size_t length, PacketHandler handler, void* context) {
+    LidarPacket packet;
+    size_t frames = 0;
+    size_t i = 0;
+
+    while (i < length) {
+        if (frameLength == 0) {
+            // Hunt for the header byte
+            const uint8_t* header = (const uint8_t*)memchr(data + i, HEADER, length - i);
+            if (header == NULL) {
+                skip();
+                break;
+            }
+            if (header != data + i) {
+                skip();
+                i = header - data;
+            }
+
+            // Fast path: the whole frame is in the input, decode it in place
+            if (length - i >= (size_t)FRAME_SIZE) {
+                if (validate(data + i)) {
+                    decode(data + i, packet);
+                    handler(packet, context);
+                    frames++;
+                    i += FRAME_SIZE;
+                } else {
+                    i++;  // Drop this header, resync on the next one
+                }
+                continue;
+            }
+        }
+
+        // Slow path: accumulate a frame split across calls
+        size_t needed = FRAME_SIZE - frameLength;
+        size_t chunk = (length - i < needed) ? length - i : needed;
+        memcpy(frame + frameLength, data + i, chunk);
+        frameLength += chunk;
+        i += chunk;
+
+        if (frameLength >= 2 && frame[1] != VER_LEN) {
+            skip();
+            realign();
+        } else if (frameLength == FRAME_SIZE) {
+            if (validate(frame)) {
+                decode(frame, packet);
+                handler(packet, context);
+                frames++;
+                frameLength = 0;
+            } else {
+                realign();
+            }
+        }
+    }
+
+    return frames;
+}
+
+bool LidarFramer::validate(const uint8_t* candidate) {
+    if (candidate[1] != VER_LEN) {
+        skip();
+        return false;
+    }
+    if (crc8(candidate, FRAME_SIZE - 1) != candidate[FRAME_SIZE - 1]) {
+        crcErrors++;
+        skip();
+        return false;
+    }
+    frameCount++;
+    hunting = false;
+    return true;
+}
+
+void LidarFramer::skip() {
+    if (!hunting) {
+        resyncs++;
+        hunting = true;
+    }
+}
+
+void LidarFramer::realign() {
+    // The rejected bytes may still hold the start of the real frame
+    const uint8_t* end = frame + frameLength;
+    const uint8_t* header = (const uint8_t*)memchr(frame + 1, HEADER, frameLength - 1);
+    while (header != NULL && header + 1 < end && header[1] != VER_LEN) {
+        header = (const uint8_t*)memchr(header + 1, HEADER, end - header - 1);
+    }
+    if (header == NULL) {
+        frameLength = 0;
+        return;
+    }
+    frameLength = end - header;
+    memmove(frame, header, frameLength);
+}
+
+uint8_t LidarFramer::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc = CrcTable[(crc ^ data[i]) & 0xff];
+    }
+    return crc;
+}
+
+void LidarFramer::decode(const uint8_t* frame, LidarPacket& packet) {
+    packet.speed = (frame[3] << 8) | frame[2];
+    packet.startAngle = (frame[5] << 8) | frame[4];
+
+    for (int i = 0; i < POINTS_PER_PACKET; i++) {
+        int offset = 6 + i * 3;
+        packet.distances[i] = (frame[offset + 1] << 8) | frame[offset];
+        packet.intensities[i] = frame[offset + 2];
+    }
+
+    packet.endAngle = (frame[43] << 8) | frame[42];
+    packet.timestamp = (frame[45] << 8) | frame[44];
+}
@@ -0,0 +1,120 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarHealth.cpp    */
+
+#include "../include/LidarHealth.hpp"
+
+LidarHealth::LidarHealth() {
+}
+
+void LidarHealth::begin(unsigned long now) {
+    report = {};
+    windowStart = now;
+    speedSum = 0;
+    speedCount = 0;
+    windowLargestGap = 0;
+    windowGaps = 0;
+    hasLast = false;
+    revolutions = 0;
+    lastFrameTime = now;
+}
+
+void LidarHealth::addPacket(const LidarPacket& packet) {
+    speedSum += packet.speed;
+    speedCount++;
+
+    if (hasLast) {
+        // Angles run clockwise and wrap at 360, a smaller start closes a revolution
+        if (packet.startAngle < lastStartAngle) {
+            revolutions++;
+        }
+        uint16_t gap = (packet.startAngle + 36000 - lastEndAngle) % 36000;
+        if (gap > GAP_THRESHOLD) {
+            if (windowGaps < 255) {
+                windowGaps++;
+            }
+            if (gap > windowLargestGap) {
+                windowLargestGap = gap;
+            }
+        }
+    }
+    lastStartAngle = packet.startAngle;
+    lastEndAngle = packet.endAngle;
+    hasLast = true;
+}
+
+void LidarHealth::update(unsigned long now, uint32_t frames, uint32_t crcErrors) {
+    if (frames != lastFrames) {
+        lastFrames = frames;
+        lastFrameTime = now;
+        report.flags &= ~STALLED;
+    } else if (now - lastFrameTime >= stallTimeout) {
+        report.flags |= STALLED;
+        hasLast = false;  // The next packet is not a gap
+    }
+
+    unsigned long elapsed = now - windowStart;
+    if (elapsed < 1000) {
+        return;
+    }
+
+    report.packetRate = (frames - windowFrames) * 1000 / elapsed;
+    report.crcErrorRate = (crcErrors - windowCrcErrors) * 1000 / elapsed;
+    report.speed = speedCount > 0 ? speedSum / speedCount : 0;
+    report.largestGap = windowLargestGap;
+    report.gaps = windowGaps;
+
+    uint8_t flags = report.flags & STALLED;
+    uint16_t speedMargin = (uint32_t)NOMINAL_SPEED * speedTolerance / 100;
+    if (report.speed < NOMINAL_SPEED - speedMargin || report.speed > NOMINAL_SPEED + speedMargin) {
+        flags |= SLOW_ROTATION;
+    }
+    if (report.packetRate < (uint32_t)EXPECTED_PACKET_RATE * minPacketRatio / 100) {
+        flags |= PACKET_LOSS;
+    }
+    if (report.crcErrorRate > maxCrcErrorRate) {
+        flags |= CRC_ERRORS;
+    }
+    if (windowLargestGap > maxGap) {
+        flags |= ANGULAR_GAP;
+    }
+    report.flags = flags;
+
+    windowStart = now;
+    windowFrames = frames;
+    windowCrcErrors = crcErrors;
+    speedSum = 0;
+    speedCount = 0;
+    windowLargestGap = 0;
+    windowGaps = 0;
+}
+
+void LidarHealth::encode(uint8_t* out) const {
+    const uint16_t words[4] = {report.speed, report.packetRate, report.crcErrorRate, report.largestGap};
+    for (int i = 0; i < 4; i++) {
+        out[i * 2] = words[i] & 0xFF;
+        out[i * 2 + 1] = words[i] >> 8;
+    }
+    out[8] = report.gaps;
+    out[9] = report.flags;
+}
+
+bool LidarHealth::decode(const uint8_t* data, size_t length, LidarHealthReport& report) {
+    if (length != REPORT_SIZE) {
+        return false;
+    }
+    report.speed = data[0] | (data[1] << 8);
+    report.packetRate = data[2] | (data[3] << 8);
+    report.crcErrorRate = data[4] | (data[5] << 8);
+    report.largestGap = data[6] | (data[7] << 8);
+    report.gaps = data[8];
+    report.flags = data[9];
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarSectors.cpp    */
+
+#include <math.h>
+#include "../include/LidarSectors.hpp"
+
+LidarSectors::LidarSectors() {
+    reset();
+}
+
+void LidarSectors::reset() {
+    for (int k = 0; k < LEVELS; k++) {
+        for (int i = 0; i < SECTORS; i++) {
+            table[k][i] = CLEAR;
+        }
+    }
+    pending = CLEAR;
+    currentSector = -1;
+}
+
+void LidarSectors::addPoint(uint16_t angle, uint16_t distance) {
+    int sector = (angle / SECTOR_WIDTH) % SECTORS;
+
+    if (sector != currentSector) {
+        // The sweep left the previous sector, its minimum is now final
+        if (currentSector >= 0) {
+            commit(currentSector, pending);
+        }
+        currentSector = sector;
+        pending = CLEAR;
+    }
+
+    if (distance >= minValidDist && distance < pending) {
+        pending = distance;
+    }
+}
+
+void LidarSectors::commit(int sector, uint16_t distance) {
+    table[0][sector] = distance;
+
+    // Refresh every window that contains this sector, level by level
+    for (int k = 1; k < LEVELS; k++) {
+        int span = 1 << k;
+        int half = span >> 1;
+        for (int j = 0; j < span; j++) {
+            int i = (sector - j + SECTORS) % SECTORS;
+            uint16_t a = table[k - 1][i];
+            uint16_t b = table[k - 1][(i + half) % SECTORS];
+            table[k][i] = a < b ? a : b;
+        }
+    }
+}
+
+uint16_t LidarSectors::nearest(float heading, float halfWidth) const {
+    if (halfWidth >= 180.0f) {
+        halfWidth = 180.0f;
+    }
+
+    // Robot frame to sensor frame, in sectors
+    float center = heading - mountAngle;
+    int first = (int)floorf((center - halfWidth) * 100.0f / SECTOR_WIDTH);
+    int last = (int)floorf((center + halfWidth) * 100.0f / SECTOR_WIDTH);
+    int count = last - first + 1;
+    if (count > SECTORS) {
+        count = SECTORS;
+    }
+
+    first = ((first % SECTORS) + SECTORS) % SECTORS;
+    last = (first + count - 1) % SECTORS;
+
+    int k = 31 - __builtin_clz(count);  // Largest power of two window inside the range
+    int span = 1 << k;
+    uint16_t a = table[k][first];
+    uint16_t b = table[k][(last - span + 1 + SECTORS) % SECTORS];
+    return a < b ? a : b;
+}
@@ -0,0 +1,192 @@
+/*
+ __ _            __            _        _   
+/ _\ | ___   _  /__\ ___   ___| | _____| |_ 
+\ \| |/ / | | |/ \/// _ \ / __| |/ / _ \ __|
+_\ \   <| |_| / _  \ (_) | (__|   <  __/ |_ 
+\__/_|\_\\__, \/ \_/\___/ \___|_|\_\___|\__|
+         |___/                                                            
+*/
+
+/*  LidarStream.cpp    */
+
+#include <string.h>
+#include "../include/LidarStream.hpp"
+#include "../include/LidarScan.hpp"
+
+static inline void put16(uint8_t* p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static inline uint16_t get16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+LidarStream::LidarStream(Mode mode)
+    : mode(mode) {
+    pending.count = 0;
+}
+
+void LidarStream::setMode(Mode newMode) {
+    flush();
+    mode = newMode;
+}
+
+void LidarStream::addPacket(const LidarPacket& packet) {
+    if (mode == RAW) {
+        encodeFrame(packet, out + HEADER_SIZE);
+        send(TYPE_FRAME, LidarFramer::FRAME_SIZE);
+        return;
+    }
+
+    for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+        if (packet.distances[i] == 0) {
+            continue;
+        }
+        if (pending.count == 0) {
+            pending.timestamp = packet.timestamp;
+            pending.speed = packet.speed;
+        }
+        pending.angles[pending.count] = LidarScanAssembler::pointAngle(packet, i);
+        pending.distances[pending.count] = packet.distances[i];
+        pending.intensities[pending.count] = packet.intensities[i];
+        if (++pending.count == LidarPointBatch::MAX_POINTS) {
+            flush();
+        }
+    }
+}
+
+void LidarStream::flush() {
+    if (pending.count == 0) {
+        return;
+    }
+    uint8_t* payload = out + HEADER_SIZE;
+    put16(payload, pending.timestamp);
+    put16(payload + 2, pending.speed);
+    payload[4] = pending.count;
+    uint8_t* point = payload + 5;
+    for (int i = 0; i < pending.count; i++, point += POINT_SIZE) {
+        put16(point, pending.angles[i]);
+        put16(point + 2, pending.distances[i]);
+        point[4] = pending.intensities[i];
+    }
+    send(TYPE_POINTS, 5 + pending.count * POINT_SIZE);
+    pending.count = 0;
+}
+
+void LidarStream::send(Type type, size_t length) {
+    out[0] = SYNC1;
+    out[1] = SYNC2;
+    out[2] = type;
+    put16(out + 3, length);
+    out[HEADER_SIZE + length] = LidarFramer::crc8(out + 2, length + 3);
+    if (writer) {
+        writer(out, HEADER_SIZE + length + 1, writerContext);
+    }
+}
+
+void LidarStream::encodeFrame(const LidarPacket& packet, uint8_t* frame) {
+    frame[0] = LidarFramer::HEADER;
+    frame[1] = LidarFramer::VER_LEN;
+    put16(frame + 2, packet.speed);
+    put16(frame + 4, packet.startAngle);
+    for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+        int offset = 6 + i * 3;
+        put16(frame + offset, packet.distances[i]);
+        frame[offset + 2] = packet.intensities[i];
+    }
+    put16(frame + 42, packet.endAngle);
+    put16(frame + 44, packet.timestamp);
+    frame[46] = LidarFramer::crc8(frame, LidarFramer::FRAME_SIZE - 1);
+}
+
+LidarStreamDecoder::LidarStreamDecoder() {
+    reset();
+}
+
+void LidarStreamDecoder::reset() {
+    rxLength = 0;
+    expected = 0;
+    frameCount = 0;
+    crcErrors = 0;
+}
+
+size_t LidarStreamDecoder::parse(const uint8_t* data, size_t length, BatchHandler handler, void* context) {
+    size_t batches = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t b = data[i];
+
+        // Sync on the two marker bytes
+        if (rxLength == 0 && b != LidarStream::SYNC1) {
+            continue;
+        }
+        if (rxLength == 1 && b != LidarStream::SYNC2) {
+            rxLength = (b == LidarStream::SYNC1) ? 1 : 0;
+            continue;
+        }
+
+        rx[rxLength++] = b;
+        if (rxLength == LidarStream::HEADER_SIZE) {
+            size_t payload = get16(rx + 3);
+            if (payload > LidarStream::MAX_PAYLOAD) {
+                crcErrors++;
+                rxLength = 0;
+                continue;
+            }
+            expected = LidarStream::HEADER_SIZE + payload + 1;
+        }
+
+        if (rxLength >= LidarStream::HEADER_SIZE && rxLength == expected) {
+            if (dispatch(handler, context)) {
+                batches++;
+            }
+            rxLength = 0;
+        }
+    }
+    return batches;
+}
+
+bool LidarStreamDecoder::dispatch(BatchHandler handler, void* context) {
+    size_t payloadLength = expected - LidarStream::HEADER_SIZE - 1;
+    if (LidarFramer::crc8(rx + 2, payloadLength + 3) != rx[expected - 1]) {
+        crcErrors++;
+        return false;
+    }
+    frameCount++;
+
+    const uint8_t* payload = rx + LidarStream::HEADER_SIZE;
+    LidarPointBatch batch;
+
+    if (rx[2] == LidarStream::TYPE_FRAME && payloadLength == LidarFramer::FRAME_SIZE) {
+        LidarPacket packet;
+        LidarFramer::decode(payload, packet);
+        batch.timestamp = packet.timestamp;
+        batch.speed = packet.speed;
+        batch.count = LidarFramer::POINTS_PER_PACKET;
+        for (int i = 0; i < LidarFramer::POINTS_PER_PACKET; i++) {
+            batch.angles[i] = LidarScanAssembler::pointAngle(packet, i);
+            batch.distances[i] = packet.distances[i];
+            batch.intensities[i] = packet.intensities[i];
+        }
+    } else if (rx[2] == LidarStream::TYPE_POINTS && payloadLength >= 5) {
+        batch.timestamp = get16(payload);
+        batch.speed = get16(payload + 2);
+        batch.count = payload[4];
+        if (batch.count > LidarPointBatch::MAX_POINTS || payloadLength != 5 + batch.count * (size_t)LidarStream::POINT_SIZE) {
+            return false;
+        }
+        const uint8_t* point = payload + 5;
+        for (int i = 0; i < batch.count; i++, point += LidarStream::POINT_SIZE) {
+            batch.angles[i] = get16(point);
+            batch.distances[i] = get16(point + 2);
+            batch.intensities[i] = point[4];
+        }
+    } else {
+        return false;  // Unknown type, skipped
+    }
+
+    if (handler) {
+        handler(batch, context);
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+#!/bin/sh
+#
+# Copies the robot firmware's lidar driver (Code/main) into src/driver, where
+# the Arduino IDE and arduino-cli compile it along with this sketch. They build
+# a copy of the sketch folder, so it cannot include files from outside it.
+#
+# Run after changing any of these files in Code/main, or with --check to only
+# report copies that differ (the bench project runs that as a test).
+
+set -e
+
+FILES="LidarFramer LidarScan LidarSectors LidarFilter LidarHealth Lidar LidarStream"
+
+SKETCH_DIR=$(cd "$(dirname "$0")" && pwd)
+FIRMWARE_DIR="$SKETCH_DIR/../../../Code/main"
+DRIVER_DIR="$SKETCH_DIR/src/driver"
+
+status=0
+for name in $FILES; do
+    for file in "include/$name.hpp" "src/$name.cpp"; do
+        if [ "$1" = "--check" ]; then
+            if ! cmp -s "$FIRMWARE_DIR/$file" "$DRIVER_DIR/$file"; then
+                echo "out of date: src/driver/$file" >&2
+                status=1
+            fi
+        else
+            mkdir -p "$DRIVER_DIR/$(dirname "$file")"
+            cp "$FIRMWARE_DIR/$file" "$DRIVER_DIR/$file"
+        fi
+    done
+done
+
+if [ $status -ne 0 ]; then
+    echo "run $0 to update them" >&2
+fi
+exit $status